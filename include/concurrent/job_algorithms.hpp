@@ -0,0 +1,1531 @@
+/******************************************************************************/
+/*!
+ * @file   job_algorithms.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Higher level parallel algorithms built on top of the task API.
+ *
+ *   Unless stated otherwise these algorithms block the calling thread until
+ *   they are finished, helping with other work while waiting.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_ALGORITHMS_HPP
+#define JOB_ALGORITHMS_HPP
+
+#include "job_api.hpp"           // TaskMake, TaskSubmit, TaskSubmitAndWait
+#include "job_worker_local.hpp"  // WorkerLocal
+
+#include <algorithm>      // lower_bound, upper_bound, merge, copy, copy_n, move, min, max, nth_element, partial_sort, stable_sort
+#include <array>          // array
+#include <atomic>         // atomic<T>
+#include <cstddef>        // size_t
+#include <cstdint>        // uint32_t, uint64_t, UINT32_MAX
+#include <functional>     // less, hash
+#include <iterator>       // iterator_traits, make_move_iterator
+#include <memory>         // unique_ptr
+#include <tuple>          // tuple_size
+#include <type_traits>    // conditional_t, is_void_v, remove_reference_t
+#include <unordered_map>  // unordered_map
+#include <utility>        // declval, exchange, move
+#include <vector>         // vector
+
+namespace Job
+{
+  namespace detail
+  {
+    // NOTE(SR):
+    //   `best` holds the lowest matching index found so far (or `not_found`).
+    //   An ordered search must still look at anything below `best` while
+    //   an unordered search can stop everything as soon as anything matches.
+
+    template<bool k_Ordered>
+    bool searchCanSkip(const std::atomic_size_t* const best, const std::size_t not_found, const std::size_t index) noexcept
+    {
+      const std::size_t best_index = best->load(std::memory_order_relaxed);
+
+      if constexpr (k_Ordered)
+      {
+        return index >= best_index;
+      }
+      else
+      {
+        (void)index;
+        return best_index != not_found;
+      }
+    }
+
+    inline void searchReportMatch(std::atomic_size_t* const best, const std::size_t index) noexcept
+    {
+      std::size_t best_index = best->load(std::memory_order_relaxed);
+
+      while (index < best_index && !best->compare_exchange_weak(best_index, index, std::memory_order_relaxed, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    template<bool k_Ordered, typename S, typename Pred>
+    Task* parallelSearch(const std::size_t start, const std::size_t count, const S& splitter, const Pred& pred, std::atomic_size_t* const best, const std::size_t not_found, Task* const parent)
+    {
+      return TaskMake(
+       [=](Task* const task) {
+         if (searchCanSkip<k_Ordered>(best, not_found, start))
+         {
+           return;
+         }
+
+         if (count > 1u && splitter(count))
+         {
+           const std::size_t left_count    = count / 2;
+           const std::size_t right_count   = count - left_count;
+           const std::size_t right_start   = start + left_count;
+           const QueueType   parent_q_type = detail::taskQType(task);
+
+           TaskSubmit(parallelSearch<k_Ordered>(start, left_count, splitter, pred, best, not_found, task), parent_q_type);
+
+           if (!searchCanSkip<k_Ordered>(best, not_found, right_start))
+           {
+             TaskSubmit(parallelSearch<k_Ordered>(right_start, right_count, splitter, pred, best, not_found, task), parent_q_type);
+           }
+         }
+         else
+         {
+           const std::size_t end = start + count;
+
+           for (std::size_t index = start; index < end; ++index)
+           {
+             if (searchCanSkip<k_Ordered>(best, not_found, index))
+             {
+               break;
+             }
+
+             if (pred(index))
+             {
+               searchReportMatch(best, index);
+               break;
+             }
+           }
+         }
+       },
+       parent);
+    }
+
+    template<bool k_Ordered, typename S, typename Pred>
+    std::size_t parallelSearchAndWait(const std::size_t start, const std::size_t count, const S& splitter, const Pred& pred)
+    {
+      const std::size_t  not_found = start + count;
+      std::atomic_size_t best      = {not_found};
+
+      TaskSubmitAndWait(parallelSearch<k_Ordered>(start, count, splitter, pred, &best, not_found, nullptr));
+
+      return best.load(std::memory_order_relaxed);
+    }
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Finds the lowest index in [start, start + count) that satisfies \p pred.
+   *
+   *   Ranges above the best match found so far are skipped before being dispatched
+   *   and leaf ranges stop scanning as soon as they pass the best match.
+   *
+   * @tparam S
+   *   Callable splitter, must be callable like: splitter(std::size_t count)
+   *
+   * @tparam Pred
+   *   Must be callable like: bool pred(const std::size_t index)
+   *
+   * @param start
+   *   Start index for the range to be searched.
+   *
+   * @param count
+   *   \p start + count defines the end range.
+   *
+   * @param splitter
+   *   Callable splitter, must be callable like: splitter(std::size_t count)
+   *
+   * @param pred
+   *   Predicate that may be invoked on multiple threads at the same time.
+   *
+   * @return
+   *   The lowest matching index or `start + count` if nothing matched.
+   */
+  template<typename S, typename Pred>
+  std::size_t ParallelFindIf(const std::size_t start, const std::size_t count, S&& splitter, Pred&& pred)
+  {
+    return detail::parallelSearchAndWait<true>(start, count, splitter, pred);
+  }
+
+  /*!
+   * @brief
+   *   Finds the lowest index of \p data that compares equal to \p value.
+   *
+   * @tparam T
+   *   Type of the array to search, must be equality comparable.
+   *
+   * @tparam S
+   *   Callable splitter, must be callable like: splitter(std::size_t count)
+   *
+   * @param data
+   *   The start of the array to search.
+   *
+   * @param count
+   *   The number of elements in the \p data array.
+   *
+   * @param splitter
+   *   Callable splitter, must be callable like: splitter(std::size_t count)
+   *
+   * @param value
+   *   The value to search for.
+   *
+   * @return
+   *   The index of the first element equal to \p value or \p count if there are none.
+   */
+  template<typename T, typename S>
+  std::size_t ParallelFindFirst(const T* const data, const std::size_t count, S&& splitter, const T& value)
+  {
+    return detail::parallelSearchAndWait<true>(std::size_t(0u), count, splitter, [data, &value](const std::size_t index) -> bool {
+      return data[index] == value;
+    });
+  }
+
+  /*!
+   * @brief
+   *   Checks if any index in [start, start + count) satisfies \p pred.
+   *
+   *   All outstanding work is skipped as soon as any match is found.
+   *
+   * @tparam S
+   *   Callable splitter, must be callable like: splitter(std::size_t count)
+   *
+   * @tparam Pred
+   *   Must be callable like: bool pred(const std::size_t index)
+   *
+   * @return
+   *   true if at least one index satisfied \p pred.
+   */
+  template<typename S, typename Pred>
+  bool ParallelAnyOf(const std::size_t start, const std::size_t count, S&& splitter, Pred&& pred)
+  {
+    return detail::parallelSearchAndWait<false>(start, count, splitter, pred) != start + count;
+  }
+
+  /*!
+   * @brief
+   *   Checks if every index in [start, start + count) satisfies \p pred.
+   *
+   *   All outstanding work is skipped as soon as any index fails \p pred.
+   *
+   * @tparam S
+   *   Callable splitter, must be callable like: splitter(std::size_t count)
+   *
+   * @tparam Pred
+   *   Must be callable like: bool pred(const std::size_t index)
+   *
+   * @return
+   *   true if every index satisfied \p pred, also true for an empty range.
+   */
+  template<typename S, typename Pred>
+  bool ParallelAllOf(const std::size_t start, const std::size_t count, S&& splitter, Pred&& pred)
+  {
+    return !ParallelAnyOf(start, count, splitter, [&pred](const std::size_t index) -> bool { return !pred(index); });
+  }
+
+  namespace detail
+  {
+    template<typename T, typename LeafFn, typename CombineFn>
+    T reduceDeterministicImpl(const std::size_t start, const std::size_t count, const std::size_t leaf_grain, const T& identity, const LeafFn& leaf, const CombineFn& combine)
+    {
+      if (count <= leaf_grain)
+      {
+        return leaf(start, start + count);
+      }
+
+      const std::size_t left_count = count / 2;
+      T                 lhs        = identity;
+      T                 rhs        = identity;
+
+      Fork2(
+       [&]() { lhs = reduceDeterministicImpl(start, left_count, leaf_grain, identity, leaf, combine); },
+       [&]() { rhs = reduceDeterministicImpl(start + left_count, count - left_count, leaf_grain, identity, leaf, combine); });
+
+      return combine(lhs, rhs);
+    }
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Parallel reduction with a combine tree that only depends on \p count and \p leaf_grain.
+   *
+   *   The range is halved until each piece has at most \p leaf_grain items,
+   *   each piece is reduced serially by \p leaf and the results are combined
+   *   pairwise back up the same tree. Since neither the number of workers nor
+   *   which worker steals what changes the shape of the tree, non associative
+   *   operations such as floating point addition give bit identical results on every run.
+   *
+   * @tparam T
+   *   The result type, must be copyable.
+   *
+   * @tparam LeafFn
+   *   Must be callable like: T leaf(const std::size_t index_begin, const std::size_t index_end)
+   *
+   * @tparam CombineFn
+   *   Must be callable like: T combine(const T& lhs, const T& rhs)
+   *
+   * @param start
+   *   Start index for the range to be reduced.
+   *
+   * @param count
+   *   \p start + count defines the end range.
+   *
+   * @param leaf_grain
+   *   The maximum number of items reduced serially, must be kept the same for reproducible results.
+   *
+   * @param identity
+   *   The result of reducing an empty range.
+   *
+   * @param leaf
+   *   Serially reduces a range of indices, may be invoked on multiple threads at the same time.
+   *
+   * @param combine
+   *   Combines two partial results, `lhs` always being the result of the lower indices.
+   *
+   * @return
+   *   The reduced value.
+   */
+  template<typename T, typename LeafFn, typename CombineFn>
+  T ParallelReduceDeterministic(const std::size_t start, const std::size_t count, const std::size_t leaf_grain, const T& identity, LeafFn&& leaf, CombineFn&& combine)
+  {
+    if (count == 0u)
+    {
+      return identity;
+    }
+
+    return detail::reduceDeterministicImpl(start, count, leaf_grain > 0u ? leaf_grain : 1u, identity, leaf, combine);
+  }
+
+  /*!
+   * @brief
+   *   Passed as `max_parallel_depth` to `ParallelRecurse` to pick a depth based on `NumWorkers`.
+   */
+  static constexpr std::size_t k_RecurseAutoDepth = std::size_t(-1);
+
+  namespace detail
+  {
+    inline std::size_t recurseAutoDepth() noexcept
+    {
+      // Enough levels for roughly 8 leaves per worker with a binary split.
+      std::size_t depth = 3u;
+
+      for (std::size_t num_leaves = 1u; num_leaves < NumWorkers(); num_leaves *= 2u)
+      {
+        ++depth;
+      }
+
+      return depth;
+    }
+
+    template<typename Problem, typename IsBaseFn, typename SolveBaseFn, typename DivideFn, typename CombineFn>
+    struct Recursion
+    {
+      using Result        = decltype(std::declval<SolveBaseFn&>()(std::declval<const Problem&>()));
+      using SubProblems   = decltype(std::declval<DivideFn&>()(std::declval<const Problem&>()));
+      using ResultStorage = std::conditional_t<std::is_void_v<Result>, char, Result>;
+
+      static constexpr std::size_t k_Arity = std::tuple_size<SubProblems>::value;
+
+      using Results = std::array<ResultStorage, k_Arity>;
+
+      static_assert(k_Arity >= 2u, "`divide` must split a problem into at least two sub problems.");
+
+      IsBaseFn&    is_base;
+      SolveBaseFn& solve_base;
+      DivideFn&    divide;
+      CombineFn&   combine;
+
+      Result Solve(const Problem& problem, const std::size_t parallel_depth) const
+      {
+        if (is_base(problem))
+        {
+          return solve_base(problem);
+        }
+
+        const SubProblems sub_problems = divide(problem);
+        Results           results;
+
+        SolveAll(sub_problems, results, parallel_depth);
+
+        if constexpr (std::is_void_v<Result>)
+        {
+          combine(problem);
+        }
+        else
+        {
+          return combine(problem, results);
+        }
+      }
+
+      void SolveOne(const SubProblems& sub_problems, Results& results, const std::size_t index, const std::size_t parallel_depth) const
+      {
+        if constexpr (std::is_void_v<Result>)
+        {
+          (void)results;
+          Solve(sub_problems[index], parallel_depth);
+        }
+        else
+        {
+          results[index] = Solve(sub_problems[index], parallel_depth);
+        }
+      }
+
+      void SolveAll(const SubProblems& sub_problems, Results& results, const std::size_t parallel_depth) const
+      {
+        if (parallel_depth == 0u)
+        {
+          for (std::size_t i = 0u; i < k_Arity; ++i)
+          {
+            SolveOne(sub_problems, results, i, 0u);
+          }
+
+          return;
+        }
+
+        // NOTE(SR): All but the last sub problem become tasks, the last is run inline (work-first).
+
+        const std::size_t child_depth = parallel_depth - 1u;
+        Task*             tasks[k_Arity - 1u];
+
+        for (std::size_t i = 0u; i < k_Arity - 1u; ++i)
+        {
+          tasks[i] = TaskMake([this, &sub_problems, &results, i, child_depth](Task* const) {
+            SolveOne(sub_problems, results, i, child_depth);
+          });
+
+          // A finished task may be garbage collected and its slot reused before it is waited on.
+          TaskIncRef(tasks[i]);
+          TaskSubmit(tasks[i]);
+        }
+
+        SolveOne(sub_problems, results, k_Arity - 1u, child_depth);
+
+        for (Task* const task : tasks)
+        {
+          WaitOnTask(task);
+          TaskDecRef(task);
+        }
+      }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Generic parallel divide and conquer.
+   *
+   *   While \p is_base is false the problem is split by \p divide, the sub problems
+   *   are solved recursively and then merged by \p combine. All but the last sub problem
+   *   are solved by new tasks, the last one inline on the current worker. Past
+   *   \p max_parallel_depth levels the recursion continues without making tasks.
+   *
+   *   For a size based cutoff have \p is_base return true for problems small enough
+   *   to not be worth splitting and solve them serially in \p solve_base.
+   *
+   * @tparam Problem
+   *   The description of a (sub) problem, copied into the array returned by \p divide.
+   *
+   * @tparam IsBaseFn
+   *   Must be callable like: bool is_base(const Problem& problem)
+   *
+   * @tparam SolveBaseFn
+   *   Must be callable like: Result solve_base(const Problem& problem)
+   *   `Result` may be void, otherwise it must be default constructible and move assignable.
+   *
+   * @tparam DivideFn
+   *   Must be callable like: std::array<Problem, N> divide(const Problem& problem), with N >= 2.
+   *
+   * @tparam CombineFn
+   *   Must be callable like: Result combine(const Problem& problem, std::array<Result, N>& sub_results)
+   *   or `void combine(const Problem& problem)` when `Result` is void.
+   *
+   * @param problem
+   *   The root problem.
+   *
+   * @param max_parallel_depth
+   *   The number of levels that create tasks, `k_RecurseAutoDepth` picks one from `NumWorkers`.
+   *
+   * @return
+   *   The result of the root problem.
+   */
+  template<typename Problem, typename IsBaseFn, typename SolveBaseFn, typename DivideFn, typename CombineFn>
+  auto ParallelRecurse(const Problem& problem, IsBaseFn&& is_base, SolveBaseFn&& solve_base, DivideFn&& divide, CombineFn&& combine, const std::size_t max_parallel_depth = k_RecurseAutoDepth)
+  {
+    using Recursion = detail::Recursion<Problem,
+                                        std::remove_reference_t<IsBaseFn>,
+                                        std::remove_reference_t<SolveBaseFn>,
+                                        std::remove_reference_t<DivideFn>,
+                                        std::remove_reference_t<CombineFn>>;
+
+    const Recursion recursion = {is_base, solve_base, divide, combine};
+
+    return recursion.Solve(problem, max_parallel_depth == k_RecurseAutoDepth ? detail::recurseAutoDepth() : max_parallel_depth);
+  }
+
+  /*!
+   * @brief
+   *   A sorted input to `Job::ParallelMergeRuns`.
+   */
+  template<typename Iterator>
+  struct MergeRun
+  {
+    Iterator first;
+    Iterator last;
+  };
+
+  /*!
+   * @brief
+   *   Output slices smaller than this are not worth a task of their own.
+   */
+  static constexpr std::size_t k_MergeMinSliceSize = 16384u;
+
+  namespace detail
+  {
+    // NOTE(SR):
+    //   Elements are merged in the strict total order of (value, run index) which
+    //   makes the merge stable and gives every output rank a unique set of split
+    //   points, `splits[l]` being how many elements of run `l` come before the rank.
+    //
+    //   The splits are found by repeatedly taking the middle element `x` of the
+    //   largest remaining search window and counting how many elements of each run
+    //   are ordered at or before it. If that is at most `rank` all of them are
+    //   before the split (raise each `lo`) otherwise `x` and everything after it
+    //   is not (lower each `hi`).
+    //
+    //   Counts are only searched for within each run's window, clamping to the
+    //   window gives the same decision since the answer is known to be inside it.
+
+    template<typename Iterator, typename Compare>
+    struct RunMerger
+    {
+      const MergeRun<Iterator>* runs;
+      std::size_t               num_runs;
+      std::size_t               num_items;
+      Compare&                  comp;
+
+      std::size_t RunSize(const std::size_t run) const
+      {
+        return std::size_t(runs[run].last - runs[run].first);
+      }
+
+      // Fills `splits` for output `rank`, `scratch` must have `2 * num_runs` entries.
+      void CoRank(const std::size_t rank, std::size_t* const splits, std::size_t* const scratch) const
+      {
+        std::size_t* const window_lo = splits;
+        std::size_t* const window_hi = scratch;
+        std::size_t* const counts    = scratch + num_runs;
+
+        for (std::size_t run = 0u; run < num_runs; ++run)
+        {
+          const std::size_t run_size    = RunSize(run);
+          const std::size_t other_items = num_items - run_size;
+
+          window_lo[run] = rank > other_items ? rank - other_items : 0u;
+          window_hi[run] = rank < run_size ? rank : run_size;
+        }
+
+        while (true)
+        {
+          std::size_t widest_run = 0u;
+
+          for (std::size_t run = 1u; run < num_runs; ++run)
+          {
+            if (window_hi[run] - window_lo[run] > window_hi[widest_run] - window_lo[widest_run])
+            {
+              widest_run = run;
+            }
+          }
+
+          if (window_hi[widest_run] == window_lo[widest_run])
+          {
+            return;
+          }
+
+          const std::size_t mid   = window_lo[widest_run] + (window_hi[widest_run] - window_lo[widest_run]) / 2u;
+          const auto&       pivot = runs[widest_run].first[mid];
+          std::size_t       total = 0u;
+
+          for (std::size_t run = 0u; run < num_runs; ++run)
+          {
+            const Iterator lo_it = runs[run].first + window_lo[run];
+            const Iterator hi_it = runs[run].first + window_hi[run];
+
+            // Equal elements of earlier runs are ordered before the pivot, of later runs after it.
+            if (run == widest_run)
+            {
+              counts[run] = mid + 1u;
+            }
+            else if (run < widest_run)
+            {
+              counts[run] = window_lo[run] + std::size_t(std::upper_bound(lo_it, hi_it, pivot, comp) - lo_it);
+            }
+            else
+            {
+              counts[run] = window_lo[run] + std::size_t(std::lower_bound(lo_it, hi_it, pivot, comp) - lo_it);
+            }
+
+            total += counts[run];
+          }
+
+          if (total <= rank)
+          {
+            std::copy_n(counts, num_runs, window_lo);
+          }
+          else
+          {
+            std::copy_n(counts, num_runs, window_hi);
+            window_hi[widest_run] = mid;
+          }
+        }
+      }
+
+      // Serially merges the runs' elements in [begin_splits, end_splits) into `out`.
+      template<typename OutputIt>
+      void MergeSlice(const std::size_t* const begin_splits, const std::size_t* const end_splits, OutputIt out) const
+      {
+        using Value = typename std::iterator_traits<Iterator>::value_type;
+
+        // NOTE(SR):
+        //   Rounds of pairwise `std::merge` rather than a heap or loser tree, the two way
+        //   merge loop compiles to conditional moves while a k-way selection is a chain of
+        //   dependent loads and branches per element which measured about twice as slow.
+
+        std::vector<MergeRun<Iterator>> inputs;
+        std::size_t                     slice_size = 0u;
+
+        for (std::size_t run = 0u; run < num_runs; ++run)
+        {
+          if (begin_splits[run] != end_splits[run])
+          {
+            inputs.push_back({runs[run].first + begin_splits[run], runs[run].first + end_splits[run]});
+            slice_size += end_splits[run] - begin_splits[run];
+          }
+        }
+
+        if (inputs.size() <= 2u)
+        {
+          if (inputs.size() == 1u)
+          {
+            std::copy(inputs[0].first, inputs[0].last, out);
+          }
+          else if (inputs.size() == 2u)
+          {
+            std::merge(inputs[0].first, inputs[0].last, inputs[1].first, inputs[1].last, out, comp);
+          }
+
+          return;
+        }
+
+        std::vector<Value>       src_buffer(slice_size);
+        std::vector<Value>       dst_buffer(slice_size);
+        std::vector<std::size_t> bounds     = {0u};
+        std::vector<std::size_t> new_bounds = {};
+
+        for (std::size_t i = 0u; i < inputs.size(); i += 2u)
+        {
+          Value* const dst     = src_buffer.data() + bounds.back();
+          Value* const dst_end = i + 1u < inputs.size() ?
+                                  std::merge(inputs[i].first, inputs[i].last, inputs[i + 1u].first, inputs[i + 1u].last, dst, comp) :
+                                  std::copy(inputs[i].first, inputs[i].last, dst);
+
+          bounds.push_back(std::size_t(dst_end - src_buffer.data()));
+        }
+
+        const auto Moved = [](Value* const ptr) { return std::make_move_iterator(ptr); };
+
+        while (bounds.size() > 3u)
+        {
+          Value* const src = src_buffer.data();
+          Value* const dst = dst_buffer.data();
+
+          new_bounds.assign(1u, 0u);
+
+          for (std::size_t i = 0u; i + 1u < bounds.size(); i += 2u)
+          {
+            Value* const dst_end = i + 2u < bounds.size() ?
+                                    std::merge(Moved(src + bounds[i]), Moved(src + bounds[i + 1u]), Moved(src + bounds[i + 1u]), Moved(src + bounds[i + 2u]), dst + bounds[i], comp) :
+                                    std::move(src + bounds[i], src + bounds[i + 1u], dst + bounds[i]);
+
+            new_bounds.push_back(std::size_t(dst_end - dst));
+          }
+
+          bounds.swap(new_bounds);
+          src_buffer.swap(dst_buffer);
+        }
+
+        Value* const src = src_buffer.data();
+
+        std::merge(Moved(src + bounds[0]), Moved(src + bounds[1]), Moved(src + bounds[1]), Moved(src + bounds[2]), out, comp);
+      }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Stable parallel merge of \p num_runs sorted runs into \p out.
+   *
+   *   The output is cut into independent slices, each slice finds where it starts
+   *   and ends in every run by co-ranking (a k-way binary search) then merges its
+   *   part of the runs without any synchronization with other slices.
+   *
+   *   A slice that overlaps more than two runs merges them pairwise through two
+   *   temporary buffers of the slice's size.
+   *
+   *   Blocks until finished.
+   *
+   * @tparam Iterator
+   *   Random access iterator of the runs, its value type must be default constructible and copyable.
+   *
+   * @tparam OutputIt
+   *   Random access iterator of the output, must not overlap any run.
+   *
+   * @param runs
+   *   The sorted runs, equal elements are output in run order.
+   *
+   * @param num_runs
+   *   The number of elements in the \p runs array.
+   *
+   * @param out
+   *   Receives the sum of the run sizes elements.
+   *
+   * @param comp
+   *   Strict weak ordering the runs are sorted by.
+   */
+  template<typename Iterator, typename OutputIt, typename Compare = std::less<>>
+  void ParallelMergeRuns(const MergeRun<Iterator>* const runs, const std::size_t num_runs, OutputIt out, Compare comp = {})
+  {
+    using Merger = detail::RunMerger<Iterator, Compare>;
+
+    std::size_t num_items = 0u;
+
+    for (std::size_t run = 0u; run < num_runs; ++run)
+    {
+      num_items += std::size_t(runs[run].last - runs[run].first);
+    }
+
+    if (num_items == 0u)
+    {
+      return;
+    }
+
+    const Merger      merger     = {runs, num_runs, num_items, comp};
+    const std::size_t max_slices = std::size_t(NumWorkers()) * 4u;
+    const std::size_t num_slices = std::max(std::size_t(1u), std::min(num_items / k_MergeMinSliceSize, max_slices));
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_slices, Splitter::MaxItemsPerTask(1u), [&merger, out, num_items, num_slices, num_runs](Task* const, const std::size_t slice) {
+       const std::size_t rank_begin = num_items * slice / num_slices;
+       const std::size_t rank_end   = num_items * (slice + 1u) / num_slices;
+
+       // [begin splits, end splits, co-rank scratch (2x)]
+       std::unique_ptr<std::size_t[]> storage{new std::size_t[num_runs * 4u]};
+       std::size_t* const             begin_splits = storage.get();
+       std::size_t* const             end_splits   = begin_splits + num_runs;
+       std::size_t* const             scratch      = end_splits + num_runs;
+
+       merger.CoRank(rank_begin, begin_splits, scratch);
+       merger.CoRank(rank_end, end_splits, scratch);
+       merger.MergeSlice(begin_splits, end_splits, out + rank_begin);
+     }));
+  }
+
+  /*!
+   * @brief
+   *   Ranges at most this large are sorted serially by `Job::ParallelSort`.
+   */
+  static constexpr std::size_t k_SortSerialThreshold = std::size_t(1u) << 15;
+
+  /*!
+   * @brief
+   *   Stable parallel sort.
+   *
+   *   The range is cut into one run per worker, the runs are sorted concurrently
+   *   with `std::stable_sort` then combined by `Job::ParallelMergeRuns` into a
+   *   scratch buffer which is moved back in parallel.
+   *
+   *   Blocks until finished.
+   *
+   * @tparam RandomIt
+   *   Random access iterator, its value type must be default constructible and movable.
+   *
+   * @param first
+   *   The start of the range to sort.
+   *
+   * @param last
+   *   The end of the range to sort.
+   *
+   * @param comp
+   *   Strict weak ordering, equal elements keep their relative order.
+   */
+  template<typename RandomIt, typename Compare = std::less<>>
+  void ParallelSort(const RandomIt first, const RandomIt last, Compare comp = {})
+  {
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t count    = std::size_t(last - first);
+    const std::size_t num_runs = std::min(std::size_t(NumWorkers()), count / k_SortSerialThreshold);
+
+    if (num_runs < 2u)
+    {
+      std::stable_sort(first, last, comp);
+      return;
+    }
+
+    std::vector<MergeRun<RandomIt>> runs(num_runs);
+
+    for (std::size_t run = 0u; run < num_runs; ++run)
+    {
+      runs[run] = {first + count * run / num_runs, first + count * (run + 1u) / num_runs};
+    }
+
+    MergeRun<RandomIt>* const runs_data = runs.data();
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_runs, Splitter::MaxItemsPerTask(1u), [runs_data, &comp](Task* const, const std::size_t run) {
+       std::stable_sort(runs_data[run].first, runs_data[run].last, comp);
+     }));
+
+    std::vector<Value> scratch(count);
+    Value* const       scratch_data = scratch.data();
+
+    ParallelMergeRuns(runs_data, num_runs, scratch_data, comp);
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_runs, Splitter::MaxItemsPerTask(1u), [runs_data, scratch_data](Task* const, const std::size_t run) {
+       const MergeRun<RandomIt>& range     = runs_data[run];
+       const std::size_t         run_begin = std::size_t(range.first - runs_data[0].first);
+
+       std::move(scratch_data + run_begin, scratch_data + run_begin + std::size_t(range.last - range.first), range.first);
+     }));
+  }
+
+  /*!
+   * @brief
+   *   The number of input elements each task of `Job::ParallelReduceByKeySorted`
+   *   and `Job::ParallelReduceByKey` covers.
+   */
+  static constexpr std::size_t k_ReduceByKeyChunkSize = 16384u;
+
+  namespace detail
+  {
+    template<typename K, typename V, typename Op>
+    struct SegmentedReducer
+    {
+      const K*                       keys;
+      const V*                       values;
+      std::size_t                    count;
+      std::size_t                    num_chunks;
+      Op&                            op;
+      std::unique_ptr<std::size_t[]> chunk_offsets;     //!< Number of segment heads in the chunk, then the exclusive scan of that.
+      std::unique_ptr<std::size_t[]> chunk_carry_ends;  //!< Index of the chunk's first segment head, the chunk end if it has none.
+      std::unique_ptr<V[]>           chunk_carries;     //!< Reduction of [chunk begin, carry end), unset when that is empty.
+
+      SegmentedReducer(const K* const keys, const V* const values, const std::size_t count, Op& op) :
+        keys{keys},
+        values{values},
+        count{count},
+        num_chunks{(count + k_ReduceByKeyChunkSize - 1u) / k_ReduceByKeyChunkSize},
+        op{op},
+        chunk_offsets{new std::size_t[num_chunks]},
+        chunk_carry_ends{new std::size_t[num_chunks]},
+        chunk_carries{new V[num_chunks]}
+      {
+      }
+
+      std::size_t ChunkBegin(const std::size_t chunk) const { return chunk * k_ReduceByKeyChunkSize; }
+      std::size_t ChunkEnd(const std::size_t chunk) const { return std::min(count, (chunk + 1u) * k_ReduceByKeyChunkSize); }
+      bool        IsHead(const std::size_t index) const { return index == 0u || !(keys[index] == keys[index - 1u]); }
+
+      void ScanChunk(const std::size_t chunk)
+      {
+        const std::size_t chunk_begin = ChunkBegin(chunk);
+        const std::size_t chunk_end   = ChunkEnd(chunk);
+        std::size_t       num_heads   = 0u;
+        std::size_t       carry_end   = chunk_end;
+
+        for (std::size_t i = chunk_begin; i < chunk_end; ++i)
+        {
+          if (IsHead(i) && num_heads++ == 0u)
+          {
+            carry_end = i;
+          }
+        }
+
+        if (carry_end != chunk_begin)
+        {
+          V carry = values[chunk_begin];
+
+          for (std::size_t i = chunk_begin + 1u; i < carry_end; ++i)
+          {
+            carry = op(carry, values[i]);
+          }
+
+          chunk_carries[chunk] = std::move(carry);
+        }
+
+        chunk_offsets[chunk]    = num_heads;
+        chunk_carry_ends[chunk] = carry_end;
+      }
+
+      // Serial exclusive scan of the head counts, returns the total number of segments.
+      std::size_t ScanOffsets()
+      {
+        std::size_t num_segments = 0u;
+
+        for (std::size_t chunk = 0u; chunk < num_chunks; ++chunk)
+        {
+          num_segments += std::exchange(chunk_offsets[chunk], num_segments);
+        }
+
+        return num_segments;
+      }
+
+      void WriteChunk(const std::size_t chunk, K* const out_keys, V* const out_values)
+      {
+        const std::size_t chunk_end  = ChunkEnd(chunk);
+        std::size_t       out_index  = chunk_offsets[chunk];
+        std::size_t       head_index = chunk_carry_ends[chunk];
+
+        while (head_index < chunk_end)
+        {
+          V           value = values[head_index];
+          std::size_t i     = head_index + 1u;
+
+          while (i < chunk_end && !IsHead(i))
+          {
+            value = op(value, values[i]);
+            ++i;
+          }
+
+          // The last segment of a chunk continues through the carries of the chunks after it until one has a head.
+          if (i == chunk_end)
+          {
+            for (std::size_t next_chunk = chunk + 1u; next_chunk < num_chunks; ++next_chunk)
+            {
+              if (chunk_carry_ends[next_chunk] != ChunkBegin(next_chunk))
+              {
+                value = op(value, chunk_carries[next_chunk]);
+              }
+
+              if (chunk_carry_ends[next_chunk] != ChunkEnd(next_chunk))
+              {
+                break;
+              }
+            }
+          }
+
+          out_keys[out_index]   = keys[head_index];
+          out_values[out_index] = std::move(value);
+          ++out_index;
+          head_index = i;
+        }
+      }
+    };
+
+    // Fibonacci hashing so the partition does not just repeat the low bits the per partition tables bucket by.
+    inline std::size_t reduceByKeyPartition(const std::size_t hash, const unsigned partition_bits) noexcept
+    {
+      return partition_bits ? std::size_t((std::uint64_t(hash) * 0x9E3779B97F4A7C15ull) >> (64u - partition_bits)) : 0u;
+    }
+
+    template<typename K, typename V, typename Op>
+    struct HashReducer
+    {
+      using Table      = std::unordered_map<K, V>;
+      using Partitions = std::vector<Table>;
+
+      const K*                       keys;
+      const V*                       values;
+      std::size_t                    count;
+      Op&                            op;
+      unsigned                       partition_bits;
+      WorkerLocal<Partitions>        worker_tables;
+      std::vector<Partitions*>       all_partitions;
+      std::unique_ptr<std::size_t[]> partition_offsets;
+
+      HashReducer(const K* const keys, const V* const values, const std::size_t count, Op& op, const unsigned partition_bits) :
+        keys{keys},
+        values{values},
+        count{count},
+        op{op},
+        partition_bits{partition_bits},
+        worker_tables{Partitions(NumPartitions())},
+        all_partitions{},
+        partition_offsets{new std::size_t[NumPartitions()]}
+      {
+      }
+
+      std::size_t NumPartitions() const { return std::size_t(1u) << partition_bits; }
+
+      void Accumulate(Table& table, const K& key, const V& value)
+      {
+        const auto it = table.find(key);
+
+        if (it != table.end())
+        {
+          it->second = op(it->second, value);
+        }
+        else
+        {
+          table.emplace(key, value);
+        }
+      }
+
+      void AccumulateChunk(const std::size_t chunk)
+      {
+        const std::size_t  chunk_begin = chunk * k_ReduceByKeyChunkSize;
+        const std::size_t  chunk_end   = std::min(count, chunk_begin + k_ReduceByKeyChunkSize);
+        Partitions&        partitions  = worker_tables.Local();
+        const std::hash<K> hasher      = {};
+
+        for (std::size_t i = chunk_begin; i < chunk_end; ++i)
+        {
+          Accumulate(partitions[reduceByKeyPartition(hasher(keys[i]), partition_bits)], keys[i], values[i]);
+        }
+      }
+
+      void GatherPartitions()
+      {
+        worker_tables.ForEach([this](Partitions& partitions) { all_partitions.push_back(&partitions); });
+      }
+
+      // Merges every worker's table of `partition` into the first worker's.
+      void MergePartition(const std::size_t partition)
+      {
+        Table& merged = (*all_partitions[0])[partition];
+
+        for (std::size_t worker = 1u; worker < all_partitions.size(); ++worker)
+        {
+          for (const auto& entry : (*all_partitions[worker])[partition])
+          {
+            Accumulate(merged, entry.first, entry.second);
+          }
+        }
+
+        partition_offsets[partition] = merged.size();
+      }
+
+      // Serial exclusive scan of the merged table sizes, returns the total number of unique keys.
+      std::size_t ScanOffsets()
+      {
+        std::size_t num_unique = 0u;
+
+        for (std::size_t partition = 0u; partition < NumPartitions(); ++partition)
+        {
+          num_unique += std::exchange(partition_offsets[partition], num_unique);
+        }
+
+        return num_unique;
+      }
+
+      void WritePartition(const std::size_t partition, K* const out_keys, V* const out_values) const
+      {
+        std::size_t out_index = partition_offsets[partition];
+
+        for (const auto& entry : (*all_partitions[0])[partition])
+        {
+          out_keys[out_index]   = entry.first;
+          out_values[out_index] = entry.second;
+          ++out_index;
+        }
+      }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Reduces every run of adjacent equal keys to a single key and value.
+   *
+   *   A parallel segmented reduction: each chunk first reduces the elements before its
+   *   first segment head (its carry into the previous segment) and counts its heads, an
+   *   exclusive scan of the counts gives each chunk its output position, then each chunk
+   *   reduces the segments starting in it, pulling in the carries of the chunks after it
+   *   when a segment spans them. Every output is written once by its owning chunk.
+   *
+   *   Blocks until finished.
+   *
+   * @tparam K
+   *   Key type, compared with `==`.
+   *
+   * @tparam V
+   *   Value type, must be copy constructible and default constructible.
+   *
+   * @param keys
+   *   The input keys, equal keys must be adjacent (such as when sorted).
+   *
+   * @param values
+   *   The input values, one per key.
+   *
+   * @param count
+   *   The number of elements in \p keys and \p values.
+   *
+   * @param op
+   *   Associative function object callable like: `V op(const V& lhs, const V& rhs)`,
+   *   values are combined in input order.
+   *
+   * @param out_keys
+   *   Receives the key of each segment, must have room for \p count elements.
+   *
+   * @param out_values
+   *   Receives the reduced value of each segment, must have room for \p count elements.
+   *
+   * @return
+   *   The number of segments written.
+   */
+  template<typename K, typename V, typename Op>
+  std::size_t ParallelReduceByKeySorted(const K* const keys, const V* const values, const std::size_t count, Op&& op, K* const out_keys, V* const out_values)
+  {
+    if (count == 0u)
+    {
+      return 0u;
+    }
+
+    detail::SegmentedReducer<K, V, std::remove_reference_t<Op>> reducer{keys, values, count, op};
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), reducer.num_chunks, Splitter::MaxItemsPerTask(1u), [&reducer](Task* const, const std::size_t chunk) {
+       reducer.ScanChunk(chunk);
+     }));
+
+    const std::size_t num_segments = reducer.ScanOffsets();
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), reducer.num_chunks, Splitter::MaxItemsPerTask(1u), [&reducer, out_keys, out_values](Task* const, const std::size_t chunk) {
+       reducer.WriteChunk(chunk, out_keys, out_values);
+     }));
+
+    return num_segments;
+  }
+
+  /*!
+   * @brief
+   *   Reduces all values sharing a key to a single key and value, keys may be in any order.
+   *
+   *   Each worker accumulates into its own hash tables (one per key partition) with
+   *   no synchronization, then the partitions are merged across workers in parallel
+   *   and written out at offsets from an exclusive scan of their sizes.
+   *
+   *   Blocks until finished.
+   *
+   * @tparam K
+   *   Key type, must work with `std::hash<K>` and `==`.
+   *
+   * @tparam V
+   *   Value type, must be copy constructible.
+   *
+   * @param keys
+   *   The input keys.
+   *
+   * @param values
+   *   The input values, one per key.
+   *
+   * @param count
+   *   The number of elements in \p keys and \p values.
+   *
+   * @param op
+   *   Associative and commutative function object callable like: `V op(const V& lhs, const V& rhs)`.
+   *
+   * @param out_keys
+   *   Receives each unique key in an unspecified order, must have room for \p count elements.
+   *
+   * @param out_values
+   *   Receives the reduced value of the key at the same index, must have room for \p count elements.
+   *
+   * @return
+   *   The number of unique keys written.
+   */
+  template<typename K, typename V, typename Op>
+  std::size_t ParallelReduceByKey(const K* const keys, const V* const values, const std::size_t count, Op&& op, K* const out_keys, V* const out_values)
+  {
+    if (count == 0u)
+    {
+      return 0u;
+    }
+
+    unsigned partition_bits = 0u;
+
+    while ((std::size_t(1u) << partition_bits) < std::size_t(NumWorkers()) * 4u)
+    {
+      ++partition_bits;
+    }
+
+    detail::HashReducer<K, V, std::remove_reference_t<Op>> reducer{keys, values, count, op, partition_bits};
+
+    const std::size_t num_chunks     = (count + k_ReduceByKeyChunkSize - 1u) / k_ReduceByKeyChunkSize;
+    const std::size_t num_partitions = reducer.NumPartitions();
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [&reducer](Task* const, const std::size_t chunk) {
+       reducer.AccumulateChunk(chunk);
+     }));
+
+    reducer.GatherPartitions();
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_partitions, Splitter::MaxItemsPerTask(1u), [&reducer](Task* const, const std::size_t partition) {
+       reducer.MergePartition(partition);
+     }));
+
+    const std::size_t num_unique = reducer.ScanOffsets();
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_partitions, Splitter::MaxItemsPerTask(1u), [&reducer, out_keys, out_values](Task* const, const std::size_t partition) {
+       reducer.WritePartition(partition, out_keys, out_values);
+     }));
+
+    return num_unique;
+  }
+
+  /*!
+   * @brief
+   *   The number of input elements each task of `Job::ParallelTopK`
+   *   and `Job::ParallelNthElement` covers.
+   */
+  static constexpr std::size_t k_SelectChunkSize = 16384u;
+
+  /*!
+   * @brief
+   *   Ranges at most this large are finished with `std::nth_element` by `Job::ParallelNthElement`.
+   */
+  static constexpr std::size_t k_NthElementSerialThreshold = std::size_t(1u) << 16;
+
+  namespace detail
+  {
+    template<typename T, typename Compare>
+    struct TopKSelector
+    {
+      const T*                       data;
+      std::size_t                    count;
+      std::size_t                    k;
+      Compare&                       comp;
+      WorkerLocal<std::vector<T>>    worker_heaps;  //!< Max heaps (by `comp`) of each worker's best `k` so far.
+
+      TopKSelector(const T* const data, const std::size_t count, const std::size_t k, Compare& comp) :
+        data{data},
+        count{count},
+        k{k},
+        comp{comp},
+        worker_heaps{}
+      {
+      }
+
+      void SelectChunk(const std::size_t chunk)
+      {
+        const std::size_t chunk_begin = chunk * k_SelectChunkSize;
+        const std::size_t chunk_end   = std::min(count, chunk_begin + k_SelectChunkSize);
+        std::vector<T>&   heap        = worker_heaps.Local();
+        std::size_t       i           = chunk_begin;
+
+        for (; i < chunk_end && heap.size() < k; ++i)
+        {
+          heap.push_back(data[i]);
+          std::push_heap(heap.begin(), heap.end(), comp);
+        }
+
+        for (; i < chunk_end; ++i)
+        {
+          // Most elements lose against the worst of the current best `k` and never touch the heap.
+          if (comp(data[i], heap.front()))
+          {
+            std::pop_heap(heap.begin(), heap.end(), comp);
+            heap.back() = data[i];
+            std::push_heap(heap.begin(), heap.end(), comp);
+          }
+        }
+      }
+    };
+
+    template<typename RandomIt, typename Compare>
+    struct NthElementPartitioner
+    {
+      using Value = typename std::iterator_traits<RandomIt>::value_type;
+
+      static constexpr std::size_t k_NumClasses = 3u;  //!< Below the low splitter, between the splitters, above the high splitter.
+      static constexpr std::size_t k_SampleSize = 1024u;
+      static constexpr std::size_t k_SampleGap  = 32u;  //!< ~sqrt(k_SampleSize) sample ranks either side of the target rank.
+
+      RandomIt                       first;
+      std::size_t                    count;
+      std::size_t                    num_chunks;
+      Compare&                       comp;
+      std::vector<Value>             scratch;
+      std::unique_ptr<std::size_t[]> chunk_offsets;  //!< `k_NumClasses` counts per chunk, then their class major exclusive scan.
+      const Value*                   low;
+      const Value*                   high;
+
+      NthElementPartitioner(Compare& comp, const std::size_t max_count) :
+        first{},
+        count{0u},
+        num_chunks{0u},
+        comp{comp},
+        scratch{},
+        chunk_offsets{new std::size_t[((max_count + k_SelectChunkSize - 1u) / k_SelectChunkSize) * k_NumClasses]},
+        low{nullptr},
+        high{nullptr}
+      {
+        scratch.reserve(max_count);
+      }
+
+      std::size_t ChunkBegin(const std::size_t chunk) const { return chunk * k_SelectChunkSize; }
+      std::size_t ChunkEnd(const std::size_t chunk) const { return std::min(count, (chunk + 1u) * k_SelectChunkSize); }
+      std::size_t ClassOf(const Value& value) const { return comp(value, *low) ? 0u : comp(*high, value) ? 2u : 1u; }
+
+      void CountChunk(const std::size_t chunk)
+      {
+        std::size_t* const counts = chunk_offsets.get() + chunk * k_NumClasses;
+
+        std::fill_n(counts, k_NumClasses, std::size_t(0u));
+
+        for (std::size_t i = ChunkBegin(chunk); i < ChunkEnd(chunk); ++i)
+        {
+          ++counts[ClassOf(first[i])];
+        }
+      }
+
+      // Serial exclusive scan of the counts ordered by class then chunk, writes the size of each class to `out_class_sizes`.
+      void ScanOffsets(std::size_t (&out_class_sizes)[k_NumClasses])
+      {
+        std::size_t offset = 0u;
+
+        for (std::size_t value_class = 0u; value_class < k_NumClasses; ++value_class)
+        {
+          const std::size_t class_begin = offset;
+
+          for (std::size_t chunk = 0u; chunk < num_chunks; ++chunk)
+          {
+            offset += std::exchange(chunk_offsets[chunk * k_NumClasses + value_class], offset);
+          }
+
+          out_class_sizes[value_class] = offset - class_begin;
+        }
+      }
+
+      void ScatterChunk(const std::size_t chunk)
+      {
+        std::size_t* const offsets = chunk_offsets.get() + chunk * k_NumClasses;
+
+        for (std::size_t i = ChunkBegin(chunk); i < ChunkEnd(chunk); ++i)
+        {
+          scratch[offsets[ClassOf(first[i])]++] = std::move(first[i]);
+        }
+      }
+
+      void GatherChunk(const std::size_t chunk)
+      {
+        const std::size_t chunk_begin = ChunkBegin(chunk);
+
+        std::move(scratch.begin() + chunk_begin, scratch.begin() + ChunkEnd(chunk), first + chunk_begin);
+      }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Copies the \p k elements that would come first if \p data were sorted by \p comp,
+   *   in that sorted order, to \p out.
+   *
+   *   Each worker keeps a heap bounded to \p k elements over the chunks it processes,
+   *   the (at most `NumWorkers() * k`) survivors are then merged serially.
+   *
+   *   Blocks until finished.
+   *
+   * @param data
+   *   The elements to select from.
+   *
+   * @param count
+   *   The number of elements in \p data.
+   *
+   * @param k
+   *   The number of elements to select.
+   *
+   * @param comp
+   *   Strict weak ordering, `std::greater<>` selects the largest elements.
+   *
+   * @param out
+   *   Receives the selected elements, must have room for `min(k, count)` elements.
+   *
+   * @return
+   *   The number of elements written, `min(k, count)`.
+   */
+  template<typename T, typename Compare = std::less<>>
+  std::size_t ParallelTopK(const T* const data, const std::size_t count, const std::size_t k, Compare comp, T* const out)
+  {
+    if (k == 0u || count == 0u)
+    {
+      return 0u;
+    }
+
+    detail::TopKSelector<T, Compare> selector{data, count, k, comp};
+
+    const std::size_t num_chunks = (count + k_SelectChunkSize - 1u) / k_SelectChunkSize;
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [&selector](Task* const, const std::size_t chunk) {
+       selector.SelectChunk(chunk);
+     }));
+
+    std::vector<T> candidates;
+
+    selector.worker_heaps.ForEach([&candidates](std::vector<T>& heap) {
+      candidates.insert(candidates.end(), std::make_move_iterator(heap.begin()), std::make_move_iterator(heap.end()));
+    });
+
+    const std::size_t num_selected = std::min(k, candidates.size());
+
+    std::partial_sort(candidates.begin(), candidates.begin() + num_selected, candidates.end(), comp);
+    std::move(candidates.begin(), candidates.begin() + num_selected, out);
+
+    return num_selected;
+  }
+
+  /*!
+   * @brief
+   *   Parallel `std::nth_element`, rearranges [first, last) so that \p nth holds the element
+   *   that would be there if the range were sorted, with nothing after it ordered before it
+   *   and nothing before it ordered after it.
+   *
+   *   Each round sorts a small random sample to pick two splitters bracketing the target
+   *   rank, then partitions the range into three classes in parallel (count, scan, scatter
+   *   through a scratch buffer) and continues with only the class holding \p nth, which
+   *   is usually a tiny fraction of the range. Small ranges finish with `std::nth_element`.
+   *
+   *   Blocks until finished.
+   *
+   * @param first
+   *   The start of the range.
+   *
+   * @param nth
+   *   The position to fix, if it is \p last nothing is done.
+   *
+   * @param last
+   *   The end of the range.
+   *
+   * @param comp
+   *   Strict weak ordering.
+   */
+  template<typename RandomIt, typename Compare = std::less<>>
+  void ParallelNthElement(RandomIt first, const RandomIt nth, RandomIt last, Compare comp = {})
+  {
+    using Partitioner = detail::NthElementPartitioner<RandomIt, Compare>;
+    using Value       = typename Partitioner::Value;
+
+    if (nth == last || std::size_t(last - first) <= k_NthElementSerialThreshold)
+    {
+      std::nth_element(first, nth, last, comp);
+      return;
+    }
+
+    Partitioner        partitioner{comp, std::size_t(last - first)};
+    std::vector<Value> sample;
+    RandomStream       rng{std::uint64_t(last - first)};
+
+    while (std::size_t(last - first) > k_NthElementSerialThreshold)
+    {
+      const std::size_t count = std::size_t(last - first);
+      const std::size_t rank  = std::size_t(nth - first);
+
+      sample.clear();
+
+      for (std::size_t i = 0u; i < Partitioner::k_SampleSize; ++i)
+      {
+        sample.push_back(first[rng.NextBounded(std::uint32_t(std::min<std::size_t>(count, UINT32_MAX)))]);
+      }
+
+      std::sort(sample.begin(), sample.end(), comp);
+
+      const std::size_t sample_rank = std::size_t(double(rank) / double(count) * double(Partitioner::k_SampleSize));
+
+      partitioner.first      = first;
+      partitioner.count      = count;
+      partitioner.num_chunks = (count + k_SelectChunkSize - 1u) / k_SelectChunkSize;
+      partitioner.low        = &sample[sample_rank > Partitioner::k_SampleGap ? sample_rank - Partitioner::k_SampleGap : 0u];
+      partitioner.high       = &sample[std::min(sample_rank + Partitioner::k_SampleGap, Partitioner::k_SampleSize - 1u)];
+      partitioner.scratch.resize(count);
+
+      TaskSubmitAndWait(ParallelFor(
+       std::size_t(0u), partitioner.num_chunks, Splitter::MaxItemsPerTask(1u), [&partitioner](Task* const, const std::size_t chunk) {
+         partitioner.CountChunk(chunk);
+       }));
+
+      std::size_t class_sizes[Partitioner::k_NumClasses];
+      partitioner.ScanOffsets(class_sizes);
+
+      const std::size_t middle_begin = class_sizes[0];
+      const std::size_t middle_end   = middle_begin + class_sizes[1];
+
+      // A round that would not shrink the range only happens with heavily duplicated data, leave it to the serial algorithm.
+      if (std::max({class_sizes[0], class_sizes[1], class_sizes[2]}) == count)
+      {
+        break;
+      }
+
+      TaskSubmitAndWait(ParallelFor(
+       std::size_t(0u), partitioner.num_chunks, Splitter::MaxItemsPerTask(1u), [&partitioner](Task* const, const std::size_t chunk) {
+         partitioner.ScatterChunk(chunk);
+       }));
+
+      TaskSubmitAndWait(ParallelFor(
+       std::size_t(0u), partitioner.num_chunks, Splitter::MaxItemsPerTask(1u), [&partitioner](Task* const, const std::size_t chunk) {
+         partitioner.GatherChunk(chunk);
+       }));
+
+      if (rank < middle_begin)
+      {
+        last = first + middle_begin;
+      }
+      else if (rank < middle_end)
+      {
+        // Every element between equivalent splitters is equivalent to them, any of them is correct at `nth`.
+        if (!comp(*partitioner.low, *partitioner.high))
+        {
+          return;
+        }
+
+        last  = first + middle_end;
+        first = first + middle_begin;
+      }
+      else
+      {
+        first = first + middle_end;
+      }
+    }
+
+    std::nth_element(first, nth, last, comp);
+  }
+}  // namespace Job
+
+#endif  // JOB_ALGORITHMS_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
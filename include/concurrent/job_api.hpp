@@ -22,9 +22,10 @@
 #include "job_assert.hpp"      // JobAssert
 #include "job_init_token.hpp"  // InitializationToken
 
-#include <cstdint>  // sized integer types
-#include <new>      // placement new
-#include <utility>  // forward, move
+#include <cstdint>      // sized integer types
+#include <new>          // placement new
+#include <type_traits>  // is_trivially_copyable_v, decay_t, remove_reference_t
+#include <utility>      // forward, move
 
 namespace Job
 {
@@ -49,6 +50,27 @@ namespace Job
     WORKER = 2,  //!< Tasks in this queue will never run on the main thread.
   };
 
+  /*!
+   * @brief
+   *   How idle workers take tasks from the queues of busy workers.
+   */
+  enum class WorkStealing : std::uint8_t
+  {
+    SHARED_DEQUES     = 0,  //!< Lock-free deques that thieves take from directly, every pop by the owner pays for a full fence.
+    PRIVATE_DEQUES    = 1,  //!< Worker threads owned by the system use deques only they touch, thieves post a request the owner answers at its next task boundary or submit (the main and user threads keep shared deques since they run code outside of tasks).
+    ASYMMETRIC_FENCES = 2,  //!< Shared deques where the owner's pop only needs a compiler barrier and each steal pays for a process wide barrier instead (`membarrier` on Linux, `FlushProcessWriteBuffers` on Windows), falls back to `SHARED_DEQUES` when neither is available.
+  };
+
+  /*!
+   * @brief
+   *   How `Job::Replay` dispatches the tasks of a `TaskGraph` once they are ready.
+   */
+  enum class TaskGraphSchedule : std::uint8_t
+  {
+    SUBMISSION_ORDER = 0,  //!< Ready tasks are pushed onto the worker queues like any other task.
+    CRITICAL_PATH    = 1,  //!< Ready `QueueType::NORMAL` tasks run highest bottom level (longest remaining path to the end of the graph) first.
+  };
+
   // Type Aliases
 
   using WorkerID = std::uint16_t;    //!< The id type of each worker thread.
@@ -84,12 +106,15 @@ namespace Job
    */
   struct JobSystemCreateOptions
   {
-    std::uint8_t  num_user_threads   = 0;     //!< The number of threads not owned by this system but wants access to the Job API (The thread must call Job::SetupUserThread).
-    std::uint8_t  num_threads        = 0;     //!< Use 0 to indicate using the number of cores available on the system.
-    std::uint16_t main_queue_size    = 256;   //!< Number of tasks in the job system's `QueueType::MAIN` queue. (Must be power of two)
-    std::uint16_t normal_queue_size  = 1024;  //!< Number of tasks in each worker's `QueueType::NORMAL` queue. (Must be power of two)
-    std::uint16_t worker_queue_size  = 32;    //!< Number of tasks in each worker's `QueueType::WORKER` queue. (Must be power of two)
-    std::uint64_t job_steal_rng_seed = 0u;    //!< The RNG for work queue stealing will be seeded with this value.
+    std::uint8_t  num_user_threads   = 0;                            //!< The number of threads not owned by this system but wants access to the Job API (The thread must call Job::SetupUserThread).
+    std::uint8_t  num_threads        = 0;                            //!< Use 0 to indicate using the number of cores available on the system.
+    std::uint16_t main_queue_size    = 256;                          //!< Number of tasks in the job system's `QueueType::MAIN` queue. (Must be power of two)
+    std::uint16_t normal_queue_size  = 1024;                         //!< Number of tasks in each worker's `QueueType::NORMAL` queue. (Must be power of two)
+    std::uint16_t worker_queue_size  = 32;                           //!< Number of tasks in each worker's `QueueType::WORKER` queue. (Must be power of two)
+    std::uint64_t job_steal_rng_seed = 0u;                           //!< The RNG for work queue stealing will be seeded with this value.
+    std::uint64_t task_rng_seed      = 0u;                           //!< Each worker's `Job::TaskRng` stream will be seeded with this value (the stream is selected by the worker's id).
+    std::uint32_t heartbeat_us       = 100u;                         //!< How often (in microseconds) a worker promotes its oldest latent fork (see `Job::HeartbeatFork2`) into a task, 0 promotes every latent fork right away.
+    WorkStealing  work_stealing      = WorkStealing::SHARED_DEQUES;  //!< How idle workers take tasks from busy ones.
   };
 
   /*!
@@ -473,6 +498,160 @@ namespace Job
    */
   void YieldTimeSlice() noexcept;
 
+  // Record / Replay API
+
+  /*!
+   * @brief
+   *   An immutable, replayable recording of the tasks made, linked and submitted by one thread.
+   */
+  struct TaskGraph;
+
+  /*!
+   * @brief
+   *   Starts capturing this thread's calls to `TaskMake`, `TaskAddContinuation` and `TaskSubmit`.
+   *
+   *   While recording tasks are made in storage owned by the graph and are not run,
+   *   submissions are remembered instead, so the recording thread must not wait on any task.
+   *   Work spawned by the recorded tasks while they run is not captured and stays dynamic.
+   *
+   *   Recorded task data is replayed by copying it so closures must be trivially copyable.
+   *
+   * @param max_tasks
+   *   The maximum number of tasks that will be recorded, at most 32767.
+   */
+  void BeginRecord(const std::uint16_t max_tasks = 4096u) noexcept;
+
+  /*!
+   * @brief
+   *   Stops recording on this thread, task pointers handed out while recording become invalid.
+   *
+   * @return
+   *   The recorded graph, must be freed with `Job::TaskGraphDestroy` before `Job::Shutdown`.
+   */
+  TaskGraph* EndRecord() noexcept;
+
+  /*!
+   * @brief
+   *   Whether this thread is between `Job::BeginRecord` and `Job::EndRecord`.
+   */
+  bool IsRecording() noexcept;
+
+  /*!
+   * @brief
+   *   Resets every recorded task to its recorded state, submits the recorded
+   *   submissions in order then waits (doing work) until every submitted task
+   *   and continuation has finished.
+   *
+   *   No tasks are allocated from or garbage collected by the worker pools.
+   *   A graph must not be replayed by multiple threads at once.
+   *
+   * @param graph
+   *   The graph to run.
+   */
+  void Replay(TaskGraph* const graph) noexcept;
+
+  /*!
+   * @brief
+   *   Gives a task being recorded an estimated cost used for `TaskGraphSchedule::CRITICAL_PATH`.
+   *
+   *   Once any task in a recording has a hint the hints are used as is and tasks without
+   *   one cost 1, otherwise costs are measured by each critical path replay (starting
+   *   from 1 per task) and used to prioritize the next one.
+   *
+   * @param task
+   *   A task made since `Job::BeginRecord` on this thread.
+   *
+   * @param cost
+   *   The relative cost of running \p task.
+   */
+  void TaskSetCostHint(Task* const task, const float cost) noexcept;
+
+  /*!
+   * @brief
+   *   Selects how ready tasks of \p graph are dispatched by later calls to `Job::Replay`.
+   */
+  void TaskGraphSetSchedule(TaskGraph* const graph, const TaskGraphSchedule schedule) noexcept;
+
+  /*!
+   * @brief
+   *   The cost of the longest path through \p graph with the costs used for the next critical path replay.
+   */
+  float TaskGraphCriticalPathCost(const TaskGraph* const graph) noexcept;
+
+  /*!
+   * @brief
+   *   The number of tasks recorded into \p graph.
+   */
+  std::size_t TaskGraphNumTasks(const TaskGraph* const graph) noexcept;
+
+  /*!
+   * @brief
+   *   Frees a graph made by `Job::EndRecord`.
+   */
+  void TaskGraphDestroy(TaskGraph* const graph) noexcept;
+
+  // Random Numbers API
+
+  /*!
+   * @brief
+   *   A PCG32 random number generator, each (seed, stream_id) pair
+   *   produces an independent and reproducible sequence.
+   *
+   *   Not thread safe, each thread should be using their own stream.
+   */
+  struct RandomStream
+  {
+    std::uint64_t state;  //!< Internal generator state.
+    std::uint64_t inc;    //!< Selects the stream, always odd.
+
+    /*!
+     * @brief
+     *   Seeds the generator.
+     *
+     * @param seed
+     *   The starting state of the generator.
+     *
+     * @param stream_id
+     *   Selects which of the 2^63 independent streams to generate from.
+     */
+    RandomStream(const std::uint64_t seed = 0u, const std::uint64_t stream_id = 0u) noexcept;
+
+    /*!
+     * @brief
+     *   Generates a uniformly distributed 32bit random number.
+     */
+    std::uint32_t Next() noexcept;
+
+    /*!
+     * @brief
+     *   Generates a uniformly distributed number in the range [0, bound).
+     */
+    std::uint32_t NextBounded(const std::uint32_t bound) noexcept;
+
+    /*!
+     * @brief
+     *   Writes the next \p count numbers of this stream to \p out.
+     */
+    void Fill(std::uint32_t* const out, const std::size_t count) noexcept;
+  };
+
+  /*!
+   * @brief
+   *   The random stream owned by the calling worker.
+   *
+   *   Each worker has their own stream so this can be used from any task without
+   *   synchronization. Which numbers a task gets depends on which worker it ran on
+   *   and what ran before it on that worker so for results that are reproducible
+   *   across runs derive a `RandomStream` from a seed and the index of the work instead.
+   *
+   * @return
+   *   The calling worker's random stream.
+   *
+   * @warning
+   *   Must only be called from a thread registered with the job system.
+   */
+  RandomStream& TaskRng() noexcept;
+
   // Template Function Implementation //
 
   template<typename T>
@@ -508,6 +687,8 @@ namespace Job
   template<typename Closure>
   Task* TaskMake(Closure&& function, Task* const parent)
   {
+    JobAssert(std::is_trivially_copyable_v<std::decay_t<Closure>> || !IsRecording(), "Recorded closures are copied on replay so must be trivially copyable.");
+
     Task* const task = TaskMake(
      +[](Task* const task) -> void {
        Closure& function = *static_cast<Closure*>(detail::taskGetPrivateUserData(task, alignof(Closure)));
@@ -708,10 +889,33 @@ namespace Job
      parent);
   }
 
+  namespace detail
+  {
+    inline void parallelInvokeImpl(Task* const, const QueueType) noexcept
+    {
+    }
+
+    template<typename F>
+    void parallelInvokeImpl(Task* const parent_task, const QueueType, F&& fn)
+    {
+      fn(parent_task);
+    }
+
+    template<typename F, typename... Fs>
+    void parallelInvokeImpl(Task* const parent_task, const QueueType q_type, F&& fn, Fs&&... fns)
+    {
+      TaskSubmit(TaskMake(std::move(fn), parent_task), q_type);
+      parallelInvokeImpl(parent_task, q_type, std::move(fns)...);
+    }
+  }  // namespace detail
+
   /*!
    * @brief
    *   Invokes each passed in function object in parallel.
    *
+   *   All but the last function object are submitted as children of the returned task,
+   *   the last one is run inline by whichever worker runs the returned task (work-first).
+   *
    * @tparam ...F
    *   The function objects types.
    *   Must be callable like: fn(Task* task)
@@ -721,6 +925,7 @@ namespace Job
    *
    * @param ...fns
    *    Function objects must be callable like: fn(Task* task)
+   *    The last function object is passed the returned task rather than a task of its own.
    *
    * @return
    *   The new task holding the work of the parallel invoke.
@@ -731,10 +936,237 @@ namespace Job
     return TaskMake(
      [=](Task* const parent_task) mutable {
        const QueueType parent_q_type = detail::taskQType(parent_task);
-       (TaskSubmit(TaskMake(std::move(fns), parent_task), parent_q_type), ...);
+       detail::parallelInvokeImpl(parent_task, parent_q_type, std::move(fns)...);
      },
      parent);
   }
+
+  /*!
+   * @brief
+   *   Blocking fork-join of two function objects.
+   *
+   *   \p a is submitted as a task while \p b is run inline on the calling worker,
+   *   then the calling worker helps with other work until \p a has finished.
+   *
+   *   Since this function does not return until both have finished the function
+   *   objects are referenced rather than copied into task storage.
+   *
+   * @tparam FA
+   *   Must be callable like: fn()
+   *
+   * @tparam FB
+   *   Must be callable like: fn()
+   *
+   * @param a
+   *   Function object run as a separate task.
+   *
+   * @param b
+   *   Function object run inline.
+   *
+   * @param queue
+   *   The queue \p a will be submitted to.
+   */
+  template<typename FA, typename FB>
+  void Fork2(FA&& a, FB&& b, const QueueType queue = QueueType::NORMAL)
+  {
+    Task* const task_a = TaskMake([&a](Task* const) { a(); });
+
+    // `b` may allocate enough tasks to garbage collect `task_a` once it has finished.
+    TaskIncRef(task_a);
+    TaskSubmit(task_a, queue);
+    b();
+    WaitOnTask(task_a);
+    TaskDecRef(task_a);
+  }
+
+  // Heartbeat Scheduling API
+
+  template<typename F>
+  void HeartbeatParallelFor(const std::size_t start, const std::size_t count, F&& fn);
+
+  namespace detail
+  {
+    static constexpr std::size_t k_LatentLoopBlockSize = 16u;  //!< Iterations `HeartbeatParallelFor` runs between polls.
+
+    struct LatentFork;
+
+    using LatentForkPromoteFn = bool (*)(LatentFork* fork);
+
+    // NOTE(SR):
+    //   Lives on the stack of the worker that made it and is only ever touched by that
+    //   worker, once promoted the real tasks are children of `join_task`.
+    struct LatentFork
+    {
+      LatentForkPromoteFn promote;    //!< Submits some of the latent work as children of `latentForkParent`, returns whether any work is still latent.
+      Task*               join_task;  //!< Parent of every task promoted from this fork, nullptr until the first promotion.
+      LatentFork*         older;      //!< The fork promoted after this one.
+      LatentFork*         newer;      //!< The fork promoted before this one.
+      bool                is_latent;  //!< Whether this fork is still in the worker's list of forks the heartbeat promotes from.
+
+      explicit LatentFork(const LatentForkPromoteFn promote) noexcept :
+        promote{promote},
+        join_task{nullptr},
+        older{nullptr},
+        newer{nullptr},
+        is_latent{false}
+      {
+      }
+    };
+
+    void  latentForkPush(LatentFork* const fork) noexcept;
+    bool  latentForkPop(LatentFork* const fork) noexcept;
+    void  latentForkJoin(LatentFork* const fork) noexcept;
+    Task* latentForkParent(LatentFork* const fork) noexcept;
+    void  heartbeatPoll() noexcept;
+
+    template<typename F>
+    struct LatentFork2 : public LatentFork
+    {
+      F* fn;
+
+      explicit LatentFork2(F* const fn) noexcept :
+        LatentFork(&Promote),
+        fn{fn}
+      {
+      }
+
+      static bool Promote(LatentFork* const fork)
+      {
+        F* const fn = static_cast<LatentFork2*>(fork)->fn;
+
+        TaskSubmit(TaskMake([fn](Task* const) { (*fn)(); }, latentForkParent(fork)));
+
+        return false;
+      }
+    };
+
+    template<typename F>
+    struct LatentForLoop : public LatentFork
+    {
+      std::size_t next;  //!< The first index the owning worker has not claimed.
+      std::size_t end;   //!< One past the last index the owning worker will run.
+      F*          fn;
+
+      LatentForLoop(const std::size_t start, const std::size_t count, F* const fn) noexcept :
+        LatentFork(&Promote),
+        next{start},
+        end{start + count},
+        fn{fn}
+      {
+      }
+
+      // Gives the upper half of the indices left to a new task.
+      static bool Promote(LatentFork* const fork)
+      {
+        LatentForLoop* const self = static_cast<LatentForLoop*>(fork);
+
+        if (self->end - self->next < 2u)
+        {
+          return false;
+        }
+
+        F* const          fn    = self->fn;
+        const std::size_t split = self->next + (self->end - self->next) / 2u;
+        const std::size_t end   = std::exchange(self->end, split);
+
+        TaskSubmit(TaskMake([fn, split, end](Task* const) { HeartbeatParallelFor(split, end - split, *fn); }, latentForkParent(fork)));
+
+        return self->end - self->next >= 2u;
+      }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Blocking fork-join of two function objects where the fork is latent.
+   *
+   *   \p a is run inline while \p b waits as a latent fork on the calling worker,
+   *   it only becomes a real (stealable) task if a heartbeat
+   *   (`JobSystemCreateOptions::heartbeat_us`) promotes it before \p a returns,
+   *   otherwise \p b is run inline too. Since each worker promotes at most one
+   *   latent fork per heartbeat, always the oldest, task creation overhead is
+   *   bounded by the heartbeat rather than by how finely the work is divided.
+   *
+   *   Like `Job::Fork2` the function objects are referenced rather than copied.
+   *
+   *   References:
+   *     [Acar, Chargueraud, Guatto, Rainey, Sieczkowski - Heartbeat Scheduling: Provable Efficiency for Nested Parallelism]
+   *
+   * @tparam FA
+   *   Must be callable like: fn()
+   *
+   * @tparam FB
+   *   Must be callable like: fn()
+   *
+   * @param a
+   *   Function object run inline.
+   *
+   * @param b
+   *   Function object run inline or, if promoted, as a separate task.
+   */
+  template<typename FA, typename FB>
+  void HeartbeatFork2(FA&& a, FB&& b)
+  {
+    detail::LatentFork2<std::remove_reference_t<FB>> fork_b{&b};
+
+    detail::latentForkPush(&fork_b);
+    a();
+
+    if (detail::latentForkPop(&fork_b))
+    {
+      b();
+    }
+    else
+    {
+      detail::latentForkJoin(&fork_b);
+    }
+  }
+
+  /*!
+   * @brief
+   *   Blocking parallel for where the iterations not yet run are a latent fork.
+   *
+   *   Indices are run in order on the calling worker, each heartbeat that
+   *   promotes this loop hands the upper half of the indices left to a new task
+   *   (which is itself a heartbeat loop), so there is no splitter to tune.
+   *
+   * @param start
+   *   Start index for the range to be parallelized.
+   *
+   * @param count
+   *    \p start + count defines the end range.
+   *
+   * @param fn
+   *   Function object must be callable like: fn(const std::size_t index)
+   */
+  template<typename F>
+  void HeartbeatParallelFor(const std::size_t start, const std::size_t count, F&& fn)
+  {
+    detail::LatentForLoop<std::remove_reference_t<F>> loop{start, count, &fn};
+
+    detail::latentForkPush(&loop);
+
+    // NOTE(SR):
+    //   `loop.end` shrinks when a heartbeat inside `fn` or `heartbeatPoll` promotes the loop,
+    //   a block is claimed before it runs so only indices past it can be promoted, and
+    //   polling once per block keeps the inner loop free of calls the body does not make.
+    while (loop.next < loop.end)
+    {
+      const std::size_t block_start = loop.next;
+
+      loop.next = loop.end - block_start > detail::k_LatentLoopBlockSize ? block_start + detail::k_LatentLoopBlockSize : loop.end;
+
+      for (std::size_t index = block_start, block_end = loop.next; index < block_end; ++index)
+      {
+        fn(index);
+      }
+
+      detail::heartbeatPoll();
+    }
+
+    detail::latentForkPop(&loop);
+    detail::latentForkJoin(&loop);
+  }
 }  // namespace Job
 
 #endif  // JOB_API_HPP
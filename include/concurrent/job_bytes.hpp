@@ -0,0 +1,247 @@
+/******************************************************************************/
+/*!
+ * @file   job_bytes.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel kernels for very large flat buffers.
+ *
+ *   Buffers are cut at fixed size, page aligned, destination addresses so
+ *   that no two tasks ever write to the same cache line or page.
+ *
+ *   Checksums are computed per chunk and the partial results combined,
+ *   which for CRCs uses the shift-combine identity
+ *   `crc(A + B) = crc(A) * x^(8 * len(B)) mod P xor crc(B)`.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_BYTES_HPP
+#define JOB_BYTES_HPP
+
+#include "job_api.hpp"  // ParallelFor
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uintptr_t, uint32_t
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   The number of destination bytes each task covers, a multiple of the page size.
+   */
+  static constexpr std::size_t k_BytesChunkSize = std::size_t(256u) << 10;
+
+  /*!
+   * @brief
+   *   Buffers at least this large are written with non-temporal stores
+   *   since they would not fit in cache anyway, falls back to regular stores on non-x86.
+   */
+  static constexpr std::size_t k_BytesStreamingThreshold = std::size_t(16u) << 20;
+
+  namespace detail
+  {
+    struct ByteChunk
+    {
+      std::size_t begin;
+      std::size_t end;
+    };
+
+    // Number of bytes from `address` to the next `k_BytesChunkSize` boundary, 0 if already on one.
+    inline std::size_t bytesHeadSize(const std::uintptr_t address) noexcept
+    {
+      return (k_BytesChunkSize - address % k_BytesChunkSize) % k_BytesChunkSize;
+    }
+
+    inline std::size_t bytesChunkCount(const std::uintptr_t address, const std::size_t num_bytes) noexcept
+    {
+      const std::size_t head_size = bytesHeadSize(address);
+
+      if (num_bytes <= head_size)
+      {
+        return num_bytes ? 1u : 0u;
+      }
+
+      return (head_size ? 1u : 0u) + (num_bytes - head_size + k_BytesChunkSize - 1u) / k_BytesChunkSize;
+    }
+
+    // Byte offsets of the `chunk_index`th chunk, every chunk but the first starts on a `k_BytesChunkSize` boundary.
+    inline ByteChunk bytesChunkRange(const std::uintptr_t address, const std::size_t num_bytes, const std::size_t chunk_index) noexcept
+    {
+      const std::size_t head_size = bytesHeadSize(address);
+      const std::size_t begin     = head_size ? (chunk_index ? head_size + (chunk_index - 1u) * k_BytesChunkSize : 0u) : chunk_index * k_BytesChunkSize;
+      const std::size_t end       = head_size && !chunk_index ? head_size : begin + k_BytesChunkSize;
+
+      return ByteChunk{begin, end < num_bytes ? end : num_bytes};
+    }
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Parallel `std::memcpy`, the buffers must not overlap.
+   *
+   * @param dst
+   *   The buffer to write to.
+   *
+   * @param src
+   *   The buffer to read from.
+   *
+   * @param num_bytes
+   *   The number of bytes to copy.
+   *
+   * @param parent
+   *   Parent task to add this task as a child of.
+   *
+   * @return
+   *   The new task holding the work, must be submitted.
+   */
+  Task* ParallelCopy(void* const dst, const void* const src, const std::size_t num_bytes, Task* const parent = nullptr);
+
+  /*!
+   * @brief
+   *   Parallel `std::memset`.
+   *
+   * @param dst
+   *   The buffer to write to.
+   *
+   * @param value
+   *   The value every byte is set to.
+   *
+   * @param num_bytes
+   *   The number of bytes to set.
+   *
+   * @param parent
+   *   Parent task to add this task as a child of.
+   *
+   * @return
+   *   The new task holding the work, must be submitted.
+   */
+  Task* ParallelFill(void* const dst, const unsigned char value, const std::size_t num_bytes, Task* const parent = nullptr);
+
+  /*!
+   * @brief
+   *   Writes `fn(src[i])` to `dst[i]` for every i in [0, count).
+   *
+   *   Chunks are cut on the same page aligned destination boundaries as `ParallelCopy`.
+   *
+   * @param src
+   *   The elements to read from.
+   *
+   * @param count
+   *   The number of elements in both \p src and \p dst.
+   *
+   * @param dst
+   *   The elements to write to, may be the same array as \p src.
+   *
+   * @param fn
+   *   Function object must be callable like: `U fn(const T& value)`
+   *
+   * @param parent
+   *   Parent task to add this task as a child of.
+   *
+   * @return
+   *   The new task holding the work, must be submitted.
+   */
+  template<typename T, typename U, typename F>
+  Task* ParallelTransform(const T* const src, const std::size_t count, U* const dst, F&& fn, Task* const parent = nullptr)
+  {
+    const std::uintptr_t address    = reinterpret_cast<std::uintptr_t>(dst);
+    const std::size_t    num_bytes  = count * sizeof(U);
+    const std::size_t    num_chunks = detail::bytesChunkCount(address, num_bytes);
+
+    return ParallelFor(
+     std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [src, dst, address, num_bytes, fn = std::forward<F>(fn)](Task* const, const std::size_t chunk_index) {
+       const detail::ByteChunk chunk = detail::bytesChunkRange(address, num_bytes, chunk_index);
+
+       // Rounding both ends up keeps neighboring chunks contiguous when `sizeof(U)` does not divide the chunk size.
+       const std::size_t index_end = (chunk.end + sizeof(U) - 1u) / sizeof(U);
+
+       for (std::size_t i = (chunk.begin + sizeof(U) - 1u) / sizeof(U); i < index_end; ++i)
+       {
+         dst[i] = fn(src[i]);
+       }
+     },
+     parent);
+  }
+
+  /*!
+   * @brief
+   *   Serial CRC-32C (Castagnoli), uses the SSE4.2 or ARMv8 CRC instructions when the CPU has them.
+   *
+   * @param data
+   *   The bytes to checksum.
+   *
+   * @param num_bytes
+   *   The number of bytes in \p data.
+   *
+   * @param crc
+   *   The CRC of the bytes preceding \p data when checksumming a buffer in pieces, 0 otherwise.
+   *
+   * @return
+   *   The CRC of the preceding bytes followed by \p data.
+   */
+  std::uint32_t Crc32c(const void* const data, const std::size_t num_bytes, const std::uint32_t crc = 0u) noexcept;
+
+  /*!
+   * @brief
+   *   Computes the CRC-32C of two buffers back to back from each buffer's CRC.
+   *
+   * @param crc_a
+   *   The CRC of the first buffer.
+   *
+   * @param crc_b
+   *   The CRC of the second buffer.
+   *
+   * @param num_bytes_b
+   *   The size of the second buffer.
+   *
+   * @return
+   *   The CRC of the first buffer followed by the second.
+   */
+  std::uint32_t Crc32cCombine(const std::uint32_t crc_a, const std::uint32_t crc_b, const std::size_t num_bytes_b) noexcept;
+
+  /*!
+   * @brief
+   *   Parallel `Job::Crc32c`, each `k_BytesChunkSize` chunk is checksummed
+   *   separately then the results are merged with `Job::Crc32cCombine`.
+   *
+   *   Blocks until finished.
+   *
+   * @param data
+   *   The bytes to checksum.
+   *
+   * @param num_bytes
+   *   The number of bytes in \p data.
+   *
+   * @return
+   *   Same result as `Job::Crc32c(data, num_bytes)`.
+   */
+  std::uint32_t ParallelCrc32c(const void* const data, const std::size_t num_bytes);
+}  // namespace Job
+
+#endif  // JOB_BYTES_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,361 @@
+/******************************************************************************/
+/*!
+ * @file   job_chunked_soa.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Structure of arrays container split into fixed size chunks for
+ *   cache resident, vectorizable parallel iteration.
+ *
+ *   Every chunk is a single 16KB allocation holding one array per component
+ *   type, each array starting on its own cache line, so a task handed a chunk
+ *   streams through a few contiguous arrays that fit in L1 and only touches
+ *   the components it reads.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_CHUNKED_SOA_HPP
+#define JOB_CHUNKED_SOA_HPP
+
+#include "job_api.hpp"     // ParallelFor, Splitter, Task
+#include "job_assert.hpp"  // JobAssert
+
+#include <cstddef>      // size_t
+#include <memory>       // unique_ptr
+#include <new>          // operator new, align_val_t, placement new
+#include <tuple>        // tuple, tuple_element_t
+#include <utility>      // index_sequence, index_sequence_for, move
+#include <vector>       // vector
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   The size of a single `ChunkedSoA` chunk allocation.
+   */
+  static constexpr std::size_t k_SoAChunkSize = 16384u;
+
+  /*!
+   * @brief
+   *   Alignment of each component array within a chunk.
+   */
+  static constexpr std::size_t k_SoAArrayAlignment = 64u;
+
+  /*!
+   * @brief
+   *   The arrays of one chunk of a `ChunkedSoA`, valid until the container is modified.
+   */
+  template<typename... Components>
+  struct SoAChunkView
+  {
+    std::tuple<Components*...> arrays;  //!< One array per component, all `count` long.
+    std::size_t                count;   //!< The number of elements in this chunk.
+    std::size_t                first;   //!< Container index of this chunk's first element.
+
+    template<std::size_t I>
+    std::tuple_element_t<I, std::tuple<Components...>>* Get() const noexcept
+    {
+      return std::get<I>(arrays);
+    }
+
+    template<typename C>
+    C* Get() const noexcept
+    {
+      return std::get<C*>(arrays);
+    }
+  };
+
+  /*!
+   * @brief
+   *   Grow only (with swap removal) container storing each component type
+   *   in its own array inside fixed size chunks.
+   *
+   *   Elements never move between chunks when the container grows so
+   *   chunk views stay valid across `PushBack`.
+   *
+   * @tparam Components
+   *   The component types of each element, each must be move constructible.
+   */
+  template<typename... Components>
+  class ChunkedSoA
+  {
+   public:
+    using ChunkView = SoAChunkView<Components...>;
+
+   private:
+    static constexpr std::size_t k_NumComponents    = sizeof...(Components);
+    static constexpr std::size_t k_ComponentSizes[] = {sizeof(Components)...};
+    static constexpr std::size_t k_BytesPerElement  = (sizeof(Components) + ...);
+    static constexpr std::size_t k_WorstCasePadding = k_NumComponents * k_SoAArrayAlignment;
+
+    static_assert(k_NumComponents > 0u, "A ChunkedSoA needs at least one component.");
+    static_assert(((alignof(Components) <= k_SoAArrayAlignment) && ...), "Component alignment is larger than the array alignment.");
+
+    static constexpr std::size_t alignUp(const std::size_t value) noexcept
+    {
+      return (value + k_SoAArrayAlignment - 1u) & ~(k_SoAArrayAlignment - 1u);
+    }
+
+   public:
+    /*!
+     * @brief
+     *   The number of elements a single chunk holds.
+     */
+    static constexpr std::size_t k_ElementsPerChunk = (k_SoAChunkSize - k_WorstCasePadding) / k_BytesPerElement;
+
+    static_assert(k_ElementsPerChunk > 0u, "The components of a single element do not fit in a chunk.");
+
+   private:
+    static constexpr std::size_t arrayOffset(const std::size_t component_index) noexcept
+    {
+      std::size_t offset = 0u;
+
+      for (std::size_t i = 0u; i < component_index; ++i)
+      {
+        offset = alignUp(offset + k_ElementsPerChunk * k_ComponentSizes[i]);
+      }
+
+      return offset;
+    }
+
+    struct ChunkDeleter
+    {
+      void operator()(unsigned char* const memory) const noexcept
+      {
+        ::operator delete(memory, std::align_val_t{k_SoAArrayAlignment});
+      }
+    };
+
+    using ChunkMemory = std::unique_ptr<unsigned char, ChunkDeleter>;
+
+   private:
+    std::vector<ChunkMemory> m_Chunks;
+    std::size_t              m_Size;
+
+   public:
+    ChunkedSoA() :
+      m_Chunks{},
+      m_Size{0u}
+    {
+    }
+
+    ChunkedSoA(const ChunkedSoA& rhs)            = delete;
+    ChunkedSoA& operator=(const ChunkedSoA& rhs) = delete;
+
+    ChunkedSoA(ChunkedSoA&& rhs) noexcept :
+      m_Chunks{std::move(rhs.m_Chunks)},
+      m_Size{std::exchange(rhs.m_Size, 0u)}
+    {
+    }
+
+    ChunkedSoA& operator=(ChunkedSoA&& rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        Clear();
+        m_Chunks = std::move(rhs.m_Chunks);
+        m_Size   = std::exchange(rhs.m_Size, 0u);
+      }
+
+      return *this;
+    }
+
+    ~ChunkedSoA()
+    {
+      Clear();
+    }
+
+    std::size_t Size() const noexcept { return m_Size; }
+    std::size_t NumChunks() const noexcept { return (m_Size + k_ElementsPerChunk - 1u) / k_ElementsPerChunk; }
+    bool        IsEmpty() const noexcept { return m_Size == 0u; }
+
+    /*!
+     * @brief
+     *   Appends an element.
+     *
+     * @return
+     *   The index of the new element.
+     */
+    template<typename... Args>
+    std::size_t PushBack(Args&&... components)
+    {
+      static_assert(sizeof...(Args) == k_NumComponents, "PushBack needs one value per component.");
+
+      const std::size_t index = m_Size;
+      const std::size_t chunk = index / k_ElementsPerChunk;
+
+      if (chunk == m_Chunks.size())
+      {
+        m_Chunks.emplace_back(static_cast<unsigned char*>(::operator new(k_SoAChunkSize, std::align_val_t{k_SoAArrayAlignment})));
+      }
+
+      constructAt(index, std::index_sequence_for<Components...>{}, std::forward<Args>(components)...);
+      ++m_Size;
+
+      return index;
+    }
+
+    /*!
+     * @brief
+     *   Removes the element at \p index by moving the last element into its place.
+     */
+    void SwapRemove(const std::size_t index)
+    {
+      JobAssert(index < m_Size, "Index out of bounds.");
+
+      const std::size_t last = m_Size - 1u;
+
+      if (index != last)
+      {
+        moveAssign(index, last, std::index_sequence_for<Components...>{});
+      }
+
+      destroyAt(last, std::index_sequence_for<Components...>{});
+      --m_Size;
+
+      // Keep a single spare chunk around to avoid thrashing at a chunk boundary.
+      while (m_Chunks.size() > NumChunks() + 1u)
+      {
+        m_Chunks.pop_back();
+      }
+    }
+
+    /*!
+     * @brief
+     *   Destroys every element and frees every chunk.
+     */
+    void Clear()
+    {
+      for (std::size_t index = 0u; index < m_Size; ++index)
+      {
+        destroyAt(index, std::index_sequence_for<Components...>{});
+      }
+
+      m_Size = 0u;
+      m_Chunks.clear();
+    }
+
+    template<std::size_t I>
+    std::tuple_element_t<I, std::tuple<Components...>>& Get(const std::size_t index) noexcept
+    {
+      JobAssert(index < m_Size, "Index out of bounds.");
+
+      return arrayOf<I>(index / k_ElementsPerChunk)[index % k_ElementsPerChunk];
+    }
+
+    template<std::size_t I>
+    const std::tuple_element_t<I, std::tuple<Components...>>& Get(const std::size_t index) const noexcept
+    {
+      return const_cast<ChunkedSoA*>(this)->Get<I>(index);
+    }
+
+    /*!
+     * @brief
+     *   The arrays of the \p chunk_index th chunk.
+     */
+    ChunkView Chunk(const std::size_t chunk_index) noexcept
+    {
+      JobAssert(chunk_index < NumChunks(), "Chunk index out of bounds.");
+
+      const std::size_t first = chunk_index * k_ElementsPerChunk;
+      const std::size_t count = m_Size - first < k_ElementsPerChunk ? m_Size - first : k_ElementsPerChunk;
+
+      return chunkView(chunk_index, first, count, std::index_sequence_for<Components...>{});
+    }
+
+   private:
+    template<std::size_t I>
+    std::tuple_element_t<I, std::tuple<Components...>>* arrayOf(const std::size_t chunk_index) const noexcept
+    {
+      return reinterpret_cast<std::tuple_element_t<I, std::tuple<Components...>>*>(m_Chunks[chunk_index].get() + arrayOffset(I));
+    }
+
+    template<std::size_t... I, typename... Args>
+    void constructAt(const std::size_t index, std::index_sequence<I...>, Args&&... components)
+    {
+      const std::size_t chunk_index = index / k_ElementsPerChunk;
+      const std::size_t slot        = index % k_ElementsPerChunk;
+
+      (new (arrayOf<I>(chunk_index) + slot) Components(std::forward<Args>(components)), ...);
+    }
+
+    template<std::size_t... I>
+    void moveAssign(const std::size_t dst_index, const std::size_t src_index, std::index_sequence<I...>)
+    {
+      ((Get<I>(dst_index) = std::move(Get<I>(src_index))), ...);
+    }
+
+    template<std::size_t... I>
+    void destroyAt(const std::size_t index, std::index_sequence<I...>)
+    {
+      const std::size_t chunk_index = index / k_ElementsPerChunk;
+      const std::size_t slot        = index % k_ElementsPerChunk;
+
+      ((arrayOf<I>(chunk_index) + slot)->~Components(), ...);
+    }
+
+    template<std::size_t... I>
+    ChunkView chunkView(const std::size_t chunk_index, const std::size_t first, const std::size_t count, std::index_sequence<I...>) const noexcept
+    {
+      return ChunkView{std::tuple<Components*...>{arrayOf<I>(chunk_index)...}, count, first};
+    }
+  };
+
+  /*!
+   * @brief
+   *   Parallel for over the chunks of a `ChunkedSoA`, each task gets whole chunks.
+   *
+   *   The container must not be resized until the returned task has finished.
+   *
+   * @param container
+   *   The container to iterate.
+   *
+   * @param fn
+   *   Function object must be callable like: fn(Job::Task* const task, const SoAChunkView<Components...>& chunk)
+   *
+   * @param parent
+   *   Parent task to add this task as a child of.
+   *
+   * @return
+   *   The new task holding the work of the parallel for, must be submitted.
+   */
+  template<typename... Components, typename F>
+  Task* ParallelForEachChunk(ChunkedSoA<Components...>& container, F&& fn, Task* const parent = nullptr)
+  {
+    ChunkedSoA<Components...>* const soa = &container;
+
+    return ParallelFor(
+     std::size_t(0u), container.NumChunks(), Splitter::MaxItemsPerTask(1u), [soa, fn = std::forward<F>(fn)](Task* const task, const std::size_t chunk_index) {
+       fn(task, soa->Chunk(chunk_index));
+     },
+     parent);
+  }
+}  // namespace Job
+
+#endif  // JOB_CHUNKED_SOA_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,286 @@
+/******************************************************************************/
+/*!
+ * @file   job_data_flow.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Data-flow tasks, dependencies are inferred from the declared read and
+ *   write sets of each task instead of being wired up by hand.
+ *
+ *   Every resource (identified by its address) remembers its last writer and
+ *   the readers since then, so a new task depends on:
+ *     - The last writer of everything it reads (read after write).
+ *     - The readers since the last write, or else the last writer, of
+ *       everything it writes (write after read, write after write).
+ *   Readers of the same resource do not depend on each other so they run in
+ *   parallel.
+ *
+ *   Tasks start as soon as they are submitted and their predecessors have
+ *   finished, edges are pushed onto a lock free successor list which is closed
+ *   when the predecessor finishes, and all nodes and edges come from arenas
+ *   that are recycled by `DataFlow::Wait` so steady state frames do not
+ *   allocate.
+ *
+ *   References:
+ *     [OmpSs / StarPU style task dependency tracking]
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_DATA_FLOW_HPP
+#define JOB_DATA_FLOW_HPP
+
+#include "job_api.hpp"  // Task
+
+#include <atomic>         // atomic
+#include <cstddef>        // size_t, max_align_t
+#include <cstdint>        // int32_t
+#include <memory>         // unique_ptr, addressof
+#include <new>            // placement new
+#include <type_traits>    // decay_t
+#include <unordered_map>  // unordered_map
+#include <utility>        // forward, move
+#include <vector>         // vector
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   The maximum number of resources a single `Reads` or `Writes` can name.
+   */
+  static constexpr std::size_t k_DataFlowMaxAccesses = 8u;
+
+  /*!
+   * @brief
+   *   The number of bytes available to store a `DataFlow` task's function object.
+   */
+  static constexpr std::size_t k_DataFlowClosureSize = 64u;
+
+  class DataFlow;
+
+  /*!
+   * @brief
+   *   A set of resources identified by their address.
+   */
+  struct DataFlowAccess
+  {
+    const void* resources[k_DataFlowMaxAccesses];  //!< The addresses of the resources accessed.
+    std::size_t count;                             //!< The number of valid entries in `resources`.
+  };
+
+  struct DataFlowReads : public DataFlowAccess
+  {
+  };
+
+  struct DataFlowWrites : public DataFlowAccess
+  {
+  };
+
+  namespace detail
+  {
+    template<typename Access, typename... Ts>
+    Access dataFlowAccess(const Ts&... resources) noexcept
+    {
+      static_assert(sizeof...(Ts) <= k_DataFlowMaxAccesses, "Too many resources named in a single access set.");
+
+      Access access = {};
+      access.count  = 0u;
+
+      ((access.resources[access.count++] = static_cast<const void*>(std::addressof(resources))), ...);
+
+      return access;
+    }
+
+    struct DataFlowNode;
+
+    struct DataFlowEdge
+    {
+      DataFlowNode* node;
+      DataFlowEdge* next;
+    };
+
+    using DataFlowInvokeFn = void (*)(DataFlowNode* node, Task* task);
+
+    struct DataFlowNode
+    {
+      alignas(std::max_align_t) unsigned char closure[k_DataFlowClosureSize];
+      DataFlowInvokeFn           invoke;            //!< Calls then destroys the function object in `closure`.
+      DataFlow*                  owner;             //!< The graph this node was submitted to.
+      std::atomic<DataFlowEdge*> successors;        //!< Closed with a sentinel once this node has finished.
+      std::atomic<std::int32_t>  num_pending;       //!< Unfinished predecessors plus one while being submitted.
+      DataFlowNode*              last_predecessor;  //!< Skips back to back duplicate edges, only touched while being submitted.
+    };
+
+    template<typename T, std::size_t k_BlockSize>
+    class DataFlowArena
+    {
+     private:
+      std::vector<std::unique_ptr<T[]>> m_Blocks;
+      std::size_t                       m_NumUsed = 0u;
+
+     public:
+      T* Allocate()
+      {
+        const std::size_t block_index = m_NumUsed / k_BlockSize;
+
+        if (block_index == m_Blocks.size())
+        {
+          m_Blocks.emplace_back(new T[k_BlockSize]);
+        }
+
+        return &m_Blocks[block_index][m_NumUsed++ % k_BlockSize];
+      }
+
+      void        Reset() noexcept { m_NumUsed = 0u; }
+      std::size_t Size() const noexcept { return m_NumUsed; }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Names the resources a data-flow task reads, each is identified by its address.
+   */
+  template<typename... Ts>
+  DataFlowReads Reads(const Ts&... resources) noexcept
+  {
+    return detail::dataFlowAccess<DataFlowReads>(resources...);
+  }
+
+  /*!
+   * @brief
+   *   Names the resources a data-flow task writes, each is identified by its address.
+   *   A resource in both the read and write set of a task is treated as written.
+   */
+  template<typename... Ts>
+  DataFlowWrites Writes(const Ts&... resources) noexcept
+  {
+    return detail::dataFlowAccess<DataFlowWrites>(resources...);
+  }
+
+  /*!
+   * @brief
+   *   Builds and runs a task graph from the declared accesses of each task.
+   *
+   *   `Submit` and `Wait` must be called from the same thread, which must be
+   *   a thread known to the job system, tasks themselves run on any worker.
+   */
+  class DataFlow
+  {
+   private:
+    struct ResourceState
+    {
+      detail::DataFlowNode* last_writer;  //!< nullptr if not written since the last `Wait`.
+      detail::DataFlowEdge* readers;      //!< The readers since `last_writer`, `node` of each edge.
+    };
+
+   private:
+    detail::DataFlowArena<detail::DataFlowNode, 256u>  m_Nodes;
+    detail::DataFlowArena<detail::DataFlowEdge, 1024u> m_Edges;
+    std::unordered_map<const void*, ResourceState>     m_Resources;
+    std::atomic<std::size_t>                           m_NumUnfinished;  //!< Unfinished nodes plus one until `Wait` is called.
+    Task*                                              m_DoneTask;       //!< Submitted by whoever finishes the last node.
+
+   public:
+    DataFlow();
+
+    DataFlow(const DataFlow& rhs)            = delete;
+    DataFlow(DataFlow&& rhs)                 = delete;
+    DataFlow& operator=(const DataFlow& rhs) = delete;
+    DataFlow& operator=(DataFlow&& rhs)      = delete;
+
+    ~DataFlow();
+
+    /*!
+     * @brief
+     *   Adds a task that runs once every earlier conflicting task has finished.
+     *
+     * @param reads
+     *   The resources \p fn reads, made by `Job::Reads`.
+     *
+     * @param writes
+     *   The resources \p fn writes, made by `Job::Writes`.
+     *
+     * @param fn
+     *   Function object must be callable like: fn(Job::Task* const task),
+     *   successors are released when \p fn returns so nested work must be waited on inside \p fn.
+     */
+    template<typename F>
+    void Submit(const DataFlowReads& reads, const DataFlowWrites& writes, F&& fn)
+    {
+      using Closure = std::decay_t<F>;
+
+      static_assert(sizeof(Closure) <= k_DataFlowClosureSize, "Cannot store object within the data-flow node's storage.");
+      static_assert(alignof(Closure) <= alignof(std::max_align_t), "Data-flow closure is over aligned.");
+
+      detail::DataFlowNode* const node = m_Nodes.Allocate();
+
+      new (node->closure) Closure(std::forward<F>(fn));
+      node->invoke = [](detail::DataFlowNode* const self, Task* const task) {
+        Closure& closure = *reinterpret_cast<Closure*>(self->closure);
+
+        closure(task);
+        closure.~Closure();
+      };
+
+      submitNode(node, reads, writes);
+    }
+
+    template<typename F>
+    void Submit(const DataFlowReads& reads, F&& fn)
+    {
+      Submit(reads, DataFlowWrites{}, std::forward<F>(fn));
+    }
+
+    template<typename F>
+    void Submit(const DataFlowWrites& writes, F&& fn)
+    {
+      Submit(DataFlowReads{}, writes, std::forward<F>(fn));
+    }
+
+    /*!
+     * @brief
+     *   Blocks (running other tasks) until every submitted task has finished,
+     *   then forgets all resource history so the graph can be reused.
+     */
+    void Wait();
+
+    /*!
+     * @brief
+     *   The number of tasks submitted since the last `Wait`.
+     */
+    std::size_t NumSubmitted() const noexcept { return m_Nodes.Size(); }
+
+   private:
+    void        submitNode(detail::DataFlowNode* const node, const DataFlowReads& reads, const DataFlowWrites& writes);
+    void        addEdge(detail::DataFlowNode* const predecessor, detail::DataFlowNode* const successor);
+    static void scheduleNode(detail::DataFlowNode* const node);
+    static void runNode(detail::DataFlowNode* const node, Task* const task);
+  };
+}  // namespace Job
+
+#endif  // JOB_DATA_FLOW_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
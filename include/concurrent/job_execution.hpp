@@ -0,0 +1,442 @@
+/******************************************************************************/
+/*!
+ * @file   job_execution.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Execution policies and standard algorithm overloads that run on the
+ *   job system's workers.
+ *
+ *   `Job::std_par::sort(Job::execution::par, first, last)` and friends take
+ *   the same arguments as their `std::` counterparts so existing call sites
+ *   only need the namespace and policy changed. Unlike the standard parallel
+ *   algorithms they need no extra threading library and never start threads
+ *   of their own.
+ *
+ *   Ranges that are not random access or are too small to be worth
+ *   splitting run the serial `std::` algorithm, as does `execution::seq`.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_EXECUTION_HPP
+#define JOB_EXECUTION_HPP
+
+#include "job_algorithms.hpp"  // ParallelFindIf, ParallelAnyOf, ParallelReduceDeterministic, ParallelSort
+#include "job_api.hpp"         // ParallelFor, TaskSubmitAndWait, NumWorkers
+
+#include <algorithm>    // for_each, transform, sort, stable_sort, fill, copy, count_if, find_if, any_of, all_of, none_of
+#include <cstddef>      // size_t
+#include <functional>   // plus, multiplies, less
+#include <iterator>     // iterator_traits, random_access_iterator_tag, next
+#include <numeric>      // reduce, transform_reduce
+#include <type_traits>  // is_same_v, is_base_of_v, decay_t, enable_if_t, integral_constant
+
+namespace Job
+{
+  namespace execution
+  {
+    /*!
+     * @brief
+     *   Runs the algorithm serially on the calling thread.
+     */
+    struct sequenced_policy
+    {
+    };
+
+    /*!
+     * @brief
+     *   Runs the algorithm on the job system's workers, the calling thread helps until it finishes.
+     *   Element access functions may be invoked concurrently and must not race.
+     */
+    struct parallel_policy
+    {
+    };
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy  par{};
+
+    template<typename T>
+    struct is_execution_policy : std::integral_constant<bool, std::is_same_v<T, sequenced_policy> || std::is_same_v<T, parallel_policy>>
+    {
+    };
+
+    template<typename T>
+    inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+  }  // namespace execution
+
+  /*!
+   * @brief
+   *   Ranges with fewer elements than this run the serial algorithm even with `execution::par`.
+   */
+  static constexpr std::size_t k_StdParSerialThreshold = 4096u;
+
+  namespace detail
+  {
+    template<typename ExecutionPolicy, typename T = void>
+    using EnableIfExecutionPolicy = std::enable_if_t<execution::is_execution_policy_v<std::decay_t<ExecutionPolicy>>, T>;
+
+    template<typename It>
+    static constexpr bool k_IsRandomAccess = std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
+    // Only the parallel policy over random access iterators is ever split, anything else runs the `std::` algorithm.
+    template<typename ExecutionPolicy, typename... Its>
+    static constexpr bool k_StdParCanSplit = std::is_same_v<std::decay_t<ExecutionPolicy>, execution::parallel_policy> && (k_IsRandomAccess<Its> && ...);
+
+    // About four tasks per worker, enough to balance uneven element costs.
+    inline Splitter stdParSplitter(const std::size_t count) noexcept
+    {
+      return Splitter::EvenSplit(count, 4u);
+    }
+
+    inline std::size_t stdParLeafGrain(const std::size_t count) noexcept
+    {
+      const std::size_t grain = count / (std::size_t(NumWorkers()) * 4u);
+
+      return grain > 1024u ? grain : 1024u;
+    }
+
+    // Calls `fn(i)` for i in [0, count) on the workers and waits.
+    template<typename F>
+    void stdParForEachIndex(const std::size_t count, F&& fn)
+    {
+      TaskSubmitAndWait(ParallelFor(
+       std::size_t(0u), count, stdParSplitter(count), [&fn](Task* const, const std::size_t index) {
+         fn(index);
+       }));
+    }
+
+    // `reduce_op(init, transform reduce of [0, count))`, leaves are never empty so
+    // `init` is only a placeholder in the combine tree and is applied once at the end.
+    template<typename T, typename ReduceOp, typename TransformIndexOp>
+    T stdParTransformReduce(const std::size_t count, const T& init, ReduceOp& reduce_op, TransformIndexOp&& transform_index)
+    {
+      const T result = ParallelReduceDeterministic(
+       std::size_t(0u),
+       count,
+       stdParLeafGrain(count),
+       init,
+       [&](const std::size_t index_begin, const std::size_t index_end) {
+         T partial = transform_index(index_begin);
+
+         for (std::size_t index = index_begin + 1u; index < index_end; ++index)
+         {
+           partial = reduce_op(partial, transform_index(index));
+         }
+
+         return partial;
+       },
+       [&](const T& lhs, const T& rhs) { return reduce_op(lhs, rhs); });
+
+      return reduce_op(init, result);
+    }
+  }  // namespace detail
+
+  namespace std_par
+  {
+    template<typename ExecutionPolicy, typename ForwardIt, typename UnaryFunction, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    void for_each(ExecutionPolicy&&, const ForwardIt first, const ForwardIt last, UnaryFunction f)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          detail::stdParForEachIndex(count, [&](const std::size_t index) { f(first[index]); });
+          return;
+        }
+      }
+
+      std::for_each(first, last, f);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename Size, typename UnaryFunction, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    ForwardIt for_each_n(ExecutionPolicy&& policy, const ForwardIt first, const Size n, UnaryFunction f)
+    {
+      if (n <= Size(0))
+      {
+        return first;
+      }
+
+      const ForwardIt last = std::next(first, n);
+
+      std_par::for_each(policy, first, last, f);
+
+      return last;
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename UnaryOperation, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    ForwardIt2 transform(ExecutionPolicy&&, const ForwardIt1 first, const ForwardIt1 last, const ForwardIt2 d_first, UnaryOperation unary_op)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt1, ForwardIt2>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          detail::stdParForEachIndex(count, [&](const std::size_t index) { d_first[index] = unary_op(first[index]); });
+          return d_first + count;
+        }
+      }
+
+      return std::transform(first, last, d_first, unary_op);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename ForwardIt3, typename BinaryOperation, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    ForwardIt3 transform(ExecutionPolicy&&, const ForwardIt1 first1, const ForwardIt1 last1, const ForwardIt2 first2, const ForwardIt3 d_first, BinaryOperation binary_op)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt1, ForwardIt2, ForwardIt3>)
+      {
+        const std::size_t count = std::size_t(last1 - first1);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          detail::stdParForEachIndex(count, [&](const std::size_t index) { d_first[index] = binary_op(first1[index], first2[index]); });
+          return d_first + count;
+        }
+      }
+
+      return std::transform(first1, last1, first2, d_first, binary_op);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename T, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    void fill(ExecutionPolicy&&, const ForwardIt first, const ForwardIt last, const T& value)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          detail::stdParForEachIndex(count, [&](const std::size_t index) { first[index] = value; });
+          return;
+        }
+      }
+
+      std::fill(first, last, value);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    ForwardIt2 copy(ExecutionPolicy&&, const ForwardIt1 first, const ForwardIt1 last, const ForwardIt2 d_first)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt1, ForwardIt2>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          detail::stdParForEachIndex(count, [&](const std::size_t index) { d_first[index] = first[index]; });
+          return d_first + count;
+        }
+      }
+
+      return std::copy(first, last, d_first);
+    }
+
+    /*!
+     * @brief
+     *   Like `std::transform_reduce`, \p reduce_op must be associative and commutative.
+     */
+    template<typename ExecutionPolicy, typename ForwardIt, typename T, typename BinaryReductionOp, typename UnaryTransformOp, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    T transform_reduce(ExecutionPolicy&&, const ForwardIt first, const ForwardIt last, T init, BinaryReductionOp reduce_op, UnaryTransformOp transform_op)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          return detail::stdParTransformReduce(count, init, reduce_op, [&](const std::size_t index) -> T { return transform_op(first[index]); });
+        }
+      }
+
+      return std::transform_reduce(first, last, init, reduce_op, transform_op);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename T, typename BinaryReductionOp, typename BinaryTransformOp, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    T transform_reduce(ExecutionPolicy&&, const ForwardIt1 first1, const ForwardIt1 last1, const ForwardIt2 first2, T init, BinaryReductionOp reduce_op, BinaryTransformOp transform_op)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt1, ForwardIt2>)
+      {
+        const std::size_t count = std::size_t(last1 - first1);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          return detail::stdParTransformReduce(count, init, reduce_op, [&](const std::size_t index) -> T { return transform_op(first1[index], first2[index]); });
+        }
+      }
+
+      return std::transform_reduce(first1, last1, first2, init, reduce_op, transform_op);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2, typename T, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    T transform_reduce(ExecutionPolicy&& policy, const ForwardIt1 first1, const ForwardIt1 last1, const ForwardIt2 first2, T init)
+    {
+      return std_par::transform_reduce(policy, first1, last1, first2, init, std::plus<>{}, std::multiplies<>{});
+    }
+
+    /*!
+     * @brief
+     *   Like `std::reduce`, \p op must be associative and commutative.
+     */
+    template<typename ExecutionPolicy, typename ForwardIt, typename T, typename BinaryOp, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    T reduce(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, T init, BinaryOp op)
+    {
+      return std_par::transform_reduce(policy, first, last, init, op, [](const auto& value) -> const auto& { return value; });
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename T, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    T reduce(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, T init)
+    {
+      return std_par::reduce(policy, first, last, init, std::plus<>{});
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    typename std::iterator_traits<ForwardIt>::value_type reduce(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last)
+    {
+      return std_par::reduce(policy, first, last, typename std::iterator_traits<ForwardIt>::value_type{}, std::plus<>{});
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    typename std::iterator_traits<ForwardIt>::difference_type count_if(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, UnaryPredicate p)
+    {
+      using Difference = typename std::iterator_traits<ForwardIt>::difference_type;
+
+      return std_par::transform_reduce(policy, first, last, Difference(0), std::plus<>{}, [&p](const auto& value) { return p(value) ? Difference(1) : Difference(0); });
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename T, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    typename std::iterator_traits<ForwardIt>::difference_type count(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, const T& value)
+    {
+      return std_par::count_if(policy, first, last, [&value](const auto& element) { return element == value; });
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    ForwardIt find_if(ExecutionPolicy&&, const ForwardIt first, const ForwardIt last, UnaryPredicate p)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          return first + ParallelFindIf(std::size_t(0u), count, detail::stdParSplitter(count), [&](const std::size_t index) -> bool { return p(first[index]); });
+        }
+      }
+
+      return std::find_if(first, last, p);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename T, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    ForwardIt find(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, const T& value)
+    {
+      return std_par::find_if(policy, first, last, [&value](const auto& element) { return element == value; });
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    bool any_of(ExecutionPolicy&&, const ForwardIt first, const ForwardIt last, UnaryPredicate p)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, ForwardIt>)
+      {
+        const std::size_t count = std::size_t(last - first);
+
+        if (count >= k_StdParSerialThreshold)
+        {
+          return ParallelAnyOf(std::size_t(0u), count, detail::stdParSplitter(count), [&](const std::size_t index) -> bool { return p(first[index]); });
+        }
+      }
+
+      return std::any_of(first, last, p);
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    bool all_of(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, UnaryPredicate p)
+    {
+      return !std_par::any_of(policy, first, last, [&p](const auto& value) -> bool { return !p(value); });
+    }
+
+    template<typename ExecutionPolicy, typename ForwardIt, typename UnaryPredicate, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    bool none_of(ExecutionPolicy&& policy, const ForwardIt first, const ForwardIt last, UnaryPredicate p)
+    {
+      return !std_par::any_of(policy, first, last, p);
+    }
+
+    /*!
+     * @brief
+     *   Like `std::stable_sort`, the parallel version is `Job::ParallelSort`.
+     */
+    template<typename ExecutionPolicy, typename RandomIt, typename Compare, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    void stable_sort(ExecutionPolicy&&, const RandomIt first, const RandomIt last, Compare comp)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, RandomIt>)
+      {
+        ParallelSort(first, last, comp);
+      }
+      else
+      {
+        std::stable_sort(first, last, comp);
+      }
+    }
+
+    template<typename ExecutionPolicy, typename RandomIt, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    void stable_sort(ExecutionPolicy&& policy, const RandomIt first, const RandomIt last)
+    {
+      std_par::stable_sort(policy, first, last, std::less<>{});
+    }
+
+    /*!
+     * @brief
+     *   Like `std::sort`, large ranges are sorted by `Job::ParallelSort`.
+     *   Not guaranteed to be stable, use `std_par::stable_sort` when the order of equal elements matters.
+     */
+    template<typename ExecutionPolicy, typename RandomIt, typename Compare, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    void sort(ExecutionPolicy&&, const RandomIt first, const RandomIt last, Compare comp)
+    {
+      if constexpr (detail::k_StdParCanSplit<ExecutionPolicy, RandomIt>)
+      {
+        // `ParallelSort` only splits with more than one worker, otherwise `std::sort` is faster than its `std::stable_sort` fallback.
+        if (std::size_t(last - first) > k_SortSerialThreshold && NumWorkers() > 1u)
+        {
+          ParallelSort(first, last, comp);
+          return;
+        }
+      }
+
+      std::sort(first, last, comp);
+    }
+
+    template<typename ExecutionPolicy, typename RandomIt, typename = detail::EnableIfExecutionPolicy<ExecutionPolicy>>
+    void sort(ExecutionPolicy&& policy, const RandomIt first, const RandomIt last)
+    {
+      std_par::sort(policy, first, last, std::less<>{});
+    }
+  }  // namespace std_par
+}  // namespace Job
+
+#endif  // JOB_EXECUTION_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,377 @@
+/******************************************************************************/
+/*!
+ * @file   job_file.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel processing of large files and streams.
+ *
+ *   Files are memory mapped and cut into fixed size chunks whose edges are
+ *   snapped forward to the next delimiter, every chunk finds its own edges
+ *   so chunks need no coordination and records are never copied.
+ *
+ *   Streams that cannot be mapped are read by the calling thread into a fixed
+ *   pool of recycled buffers, bounding the memory in flight.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_FILE_HPP
+#define JOB_FILE_HPP
+
+#include "job_api.hpp"           // ParallelFor, TaskMake, TaskSubmit, TaskAddContinuation, TaskSubmitAndWait, NumWorkers
+#include "job_assert.hpp"        // JobAssert
+#include "job_worker_local.hpp"  // WorkerLocal
+
+#include <condition_variable>  // condition_variable
+#include <cstddef>             // size_t
+#include <cstring>             // memchr
+#include <memory>              // unique_ptr
+#include <mutex>               // mutex, lock_guard, unique_lock
+#include <string_view>         // string_view
+#include <type_traits>         // remove_reference_t
+#include <vector>              // vector
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   A read only memory mapping of a whole file.
+   */
+  class MappedFile
+  {
+   private:
+    const char* m_Data;
+    std::size_t m_Size;
+    void*       m_FileHandle;     //!< Only used on Windows.
+    void*       m_MappingHandle;  //!< Only used on Windows.
+
+   public:
+    MappedFile() noexcept;
+    MappedFile(const MappedFile& rhs)            = delete;
+    MappedFile(MappedFile&& rhs)                 = delete;
+    MappedFile& operator=(const MappedFile& rhs) = delete;
+    MappedFile& operator=(MappedFile&& rhs)      = delete;
+    ~MappedFile() noexcept;
+
+    /*!
+     * @brief
+     *   Maps the file at \p path, closing any previously mapped file.
+     *
+     * @return
+     *   false if the file could not be opened or mapped.
+     */
+    bool Open(const char* const path) noexcept;
+    void Close() noexcept;
+
+    const char* Data() const noexcept { return m_Data; }
+    std::size_t Size() const noexcept { return m_Size; }
+
+    /*!
+     * @brief
+     *   Hints that [offset, offset + size) will be read front to back.
+     */
+    void AdviseSequential(const std::size_t offset, const std::size_t size) const noexcept;
+
+    /*!
+     * @brief
+     *   Hints that [offset, offset + size) will be read soon so the OS can start reading it in.
+     */
+    void AdviseWillNeed(const std::size_t offset, const std::size_t size) const noexcept;
+  };
+
+  /*!
+   * @brief
+   *   Tuning for `Job::ParallelForEachLine`.
+   */
+  struct LineOptions
+  {
+    char        delimiter  = '\n';                     //!< The byte that ends each record, it is not included in the record.
+    std::size_t chunk_size = std::size_t(4u) << 20;  //!< The number of bytes each task covers, lines longer than this still work.
+  };
+
+  namespace detail
+  {
+    // Offset of the first record starting at or after `offset`.
+    inline std::size_t lineChunkEdge(const char* const data, const std::size_t size, const std::size_t offset, const char delimiter) noexcept
+    {
+      if (offset == 0u || offset >= size)
+      {
+        return offset < size ? offset : size;
+      }
+
+      const void* const found = std::memchr(data + offset - 1u, delimiter, size - offset + 1u);
+
+      return found ? std::size_t(static_cast<const char*>(found) - data) + 1u : size;
+    }
+
+    // NOTE(SR):
+    //   The calling thread does every read and submits a task per chunk, whichever
+    //   chunk's continuation returns a buffer wakes it if it is waiting for one.
+    //
+    //   Every task is a child of `root` and is created before `root` is submitted
+    //   so `root` cannot finish until the stream has been fully processed.
+    template<typename F>
+    struct StreamState
+    {
+      F&                      fn;
+      std::size_t             chunk_size;
+      Task*                   root;
+      std::mutex              lock;
+      std::condition_variable buffer_freed;
+      std::vector<char*>      free_buffers;
+
+      StreamState(F& fn, const std::size_t chunk_size, Task* const root) :
+        fn{fn},
+        chunk_size{chunk_size},
+        root{root},
+        lock{},
+        buffer_freed{},
+        free_buffers{}
+      {
+      }
+
+      char* Acquire()
+      {
+        std::unique_lock<std::mutex> guard{lock};
+
+        buffer_freed.wait(guard, [this]() { return !free_buffers.empty(); });
+
+        char* const buffer = free_buffers.back();
+        free_buffers.pop_back();
+
+        return buffer;
+      }
+
+      void Release(char* const buffer)
+      {
+        const std::lock_guard<std::mutex> guard{lock};
+
+        free_buffers.push_back(buffer);
+        buffer_freed.notify_one();
+      }
+
+      void Submit(char* const buffer, const std::size_t num_bytes, const std::size_t chunk_index)
+      {
+        Task* const process = TaskMake([this, buffer, num_bytes, chunk_index](Task* const task) { fn(task, buffer, num_bytes, chunk_index); }, root);
+        Task* const release = TaskMake([this, buffer](Task* const) { Release(buffer); }, root);
+
+        TaskAddContinuation(process, release, QueueType::NORMAL);
+        TaskSubmit(process);
+      }
+    };
+
+    template<typename F>
+    bool forEachLineChunk(const char* const path, const LineOptions& options, const F& chunk_fn)
+    {
+      MappedFile file = {};
+
+      if (!file.Open(path))
+      {
+        return false;
+      }
+
+      const std::size_t chunk_size = options.chunk_size ? options.chunk_size : 1u;
+      const std::size_t num_chunks = (file.Size() + chunk_size - 1u) / chunk_size;
+
+      TaskSubmitAndWait(ParallelFor(
+       std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [&file, &options, &chunk_fn, chunk_size](Task* const, const std::size_t chunk_index) {
+         const char* const data        = file.Data();
+         const std::size_t size        = file.Size();
+         const std::size_t chunk_start = chunk_index * chunk_size;
+         const std::size_t begin       = lineChunkEdge(data, size, chunk_start, options.delimiter);
+         const std::size_t end         = lineChunkEdge(data, size, chunk_start + chunk_size, options.delimiter);
+
+         file.AdviseSequential(chunk_start, chunk_size);
+         file.AdviseWillNeed(chunk_start + chunk_size, chunk_size);
+
+         std::size_t line_begin = begin;
+
+         while (line_begin < end)
+         {
+           const void* const found    = std::memchr(data + line_begin, options.delimiter, end - line_begin);
+           const std::size_t line_end = found ? std::size_t(static_cast<const char*>(found) - data) : end;
+
+           chunk_fn(std::string_view(data + line_begin, line_end - line_begin));
+
+           line_begin = line_end + 1u;
+         }
+       }));
+
+      return true;
+    }
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Calls \p fn once for every record in the file at \p path, in parallel.
+   *
+   *   A final record without a trailing delimiter is still reported.
+   *   Blocks until finished.
+   *
+   * @param path
+   *   The file to read.
+   *
+   * @param fn
+   *   Function object must be callable like: fn(std::string_view line),
+   *   the view points into the mapping and is only valid during the call.
+   *
+   * @param options
+   *   Tuning parameters.
+   *
+   * @return
+   *   false if the file could not be opened or mapped.
+   */
+  template<typename F>
+  bool ParallelForEachLine(const char* const path, F&& fn, const LineOptions& options = {})
+  {
+    return detail::forEachLineChunk(path, options, fn);
+  }
+
+  /*!
+   * @brief
+   *   Calls \p fn once for every record in the file at \p path, in parallel,
+   *   along with the calling worker's slot of \p results.
+   *
+   *   Blocks until finished, afterwards \p results can be combined with `WorkerLocal::Combine`.
+   *
+   * @param path
+   *   The file to read.
+   *
+   * @param results
+   *   The per-worker accumulators.
+   *
+   * @param fn
+   *   Function object must be callable like: fn(std::string_view line, T& worker_result)
+   *
+   * @param options
+   *   Tuning parameters.
+   *
+   * @return
+   *   false if the file could not be opened or mapped.
+   */
+  template<typename T, typename F>
+  bool ParallelForEachLine(const char* const path, WorkerLocal<T>& results, F&& fn, const LineOptions& options = {})
+  {
+    return detail::forEachLineChunk(path, options, [&results, &fn](const std::string_view line) { fn(line, results.Local()); });
+  }
+
+  /*!
+   * @brief
+   *   Processes a stream that may not fit in memory, such as a pipe or a decompressor,
+   *   one chunk at a time while keeping at most \p max_in_flight chunks in memory.
+   *
+   *   The calling thread does every read, filling buffers from a recycled pool and
+   *   submitting a task per chunk, so no worker ever blocks on the stream. A chunk's buffer
+   *   is returned to the pool by a continuation once the chunk's task and all of its children
+   *   have finished, the calling thread sleeps while every buffer is in use.
+   *   Chunks are raw bytes so records may straddle two chunks.
+   *
+   *   Call it from the main thread or a thread set up with `Job::SetupUserThread`, from
+   *   inside a task the worker would be held up by the reads instead.
+   *   With a single worker there is nobody to hand chunks to, so each chunk is processed
+   *   on the calling thread right after it is read.
+   *
+   *   Blocks until the reader reports the end of the stream and every chunk is processed.
+   *
+   * @param reader
+   *   Function object must be callable like: `std::size_t reader(char* buffer, std::size_t capacity)`,
+   *   returning the number of bytes written to `buffer` with 0 meaning the end of the stream.
+   *   Only ever called by the calling thread.
+   *
+   * @param chunk_size
+   *   The size of each buffer.
+   *
+   * @param max_in_flight
+   *   The number of buffers, the reader stops reading while all of them are being processed.
+   *
+   * @param fn
+   *   Function object must be callable like:
+   *   `fn(Job::Task* task, const char* data, std::size_t size, std::size_t chunk_index)`,
+   *   children of `task` may keep using `data` since the buffer is only recycled after they finish.
+   */
+  template<typename R, typename F>
+  void ParallelForEachStream(R&& reader, const std::size_t chunk_size, const std::size_t max_in_flight, F&& fn)
+  {
+    JobAssert(chunk_size > 0u && max_in_flight > 0u, "Need at least one non-empty buffer.");
+
+    if (NumWorkers() == 1u)
+    {
+      const std::unique_ptr<char[]> buffer{new char[chunk_size]};
+      char* const                   data = buffer.get();
+
+      for (std::size_t chunk_index = 0u;; ++chunk_index)
+      {
+        const std::size_t num_bytes = reader(data, chunk_size);
+
+        if (num_bytes == 0u)
+        {
+          return;
+        }
+
+        Task* const process = TaskMake([&fn, data, num_bytes, chunk_index](Task* const task) { fn(task, data, num_bytes, chunk_index); });
+
+        // Children made by `fn` may garbage collect `process` once it has finished.
+        TaskIncRef(process);
+        TaskSubmitAndWait(process);
+        TaskDecRef(process);
+      }
+    }
+
+    using State = detail::StreamState<std::remove_reference_t<F>>;
+
+    const std::unique_ptr<char[]> storage{new char[chunk_size * max_in_flight]};
+    Task* const                   root = TaskMake([](Task* const) {});
+    State                         state{fn, chunk_size, root};
+
+    state.free_buffers.reserve(max_in_flight);
+
+    for (std::size_t i = 0u; i < max_in_flight; ++i)
+    {
+      state.free_buffers.push_back(storage.get() + i * chunk_size);
+    }
+
+    for (std::size_t chunk_index = 0u;; ++chunk_index)
+    {
+      char* const       buffer    = state.Acquire();
+      const std::size_t num_bytes = reader(buffer, chunk_size);
+
+      if (num_bytes == 0u)
+      {
+        state.Release(buffer);
+        break;
+      }
+
+      state.Submit(buffer, num_bytes, chunk_index);
+    }
+
+    TaskSubmitAndWait(root);
+  }
+}  // namespace Job
+
+#endif  // JOB_FILE_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
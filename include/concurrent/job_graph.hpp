@@ -0,0 +1,106 @@
+/******************************************************************************/
+/*!
+ * @file   job_graph.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel graph traversal over graphs stored in compressed sparse row form.
+ *
+ *   References:
+ *     [Direction-Optimizing Breadth-First Search (Beamer, Asanovic, Patterson)]
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_GRAPH_HPP
+#define JOB_GRAPH_HPP
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t, uint64_t, int32_t
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   A non owning view of a directed graph in compressed sparse row form.
+   *
+   *   The out edges of vertex `v` are `columns[row_offsets[v]]` to `columns[row_offsets[v + 1] - 1]`.
+   */
+  struct CSRGraph
+  {
+    const std::uint64_t* row_offsets;   //!< Has `num_vertices + 1` entries.
+    const std::uint32_t* columns;       //!< Has `row_offsets[num_vertices]` entries.
+    std::uint32_t        num_vertices;  //!< The number of vertices in the graph.
+
+    std::uint64_t NumEdges() const noexcept { return row_offsets[num_vertices]; }
+    std::uint64_t Degree(const std::uint32_t vertex) const noexcept { return row_offsets[vertex + 1u] - row_offsets[vertex]; }
+  };
+
+  /*!
+   * @brief
+   *   Tuning for `Job::ParallelBFS`.
+   */
+  struct BFSOptions
+  {
+    const CSRGraph* transposed        = nullptr;  //!< The graph with every edge reversed, used by bottom-up steps. nullptr means the graph is symmetric (undirected).
+    std::uint32_t   alpha             = 14u;      //!< Switch to bottom-up once the frontier's edges exceed the unexplored edges / alpha.
+    std::uint32_t   beta              = 24u;      //!< Switch back to top-down once the frontier has less than num_vertices / beta vertices.
+    bool            allow_bottom_up   = true;     //!< Set to false to always run top-down steps.
+    std::uint32_t   vertices_per_task = 1024u;    //!< The number of frontier (top-down) or graph (bottom-up) vertices each task processes.
+  };
+
+  /*!
+   * @brief
+   *   Level synchronous, direction optimizing, parallel breadth first search.
+   *
+   *   Each level is a `ParallelFor` over either the frontier (top-down) or all unvisited
+   *   vertices (bottom-up), the next frontier is gathered in per-worker buffers and
+   *   vertices are claimed through an atomic visited bitmap.
+   *
+   *   Blocks until finished.
+   *
+   * @param graph
+   *   The graph to traverse.
+   *
+   * @param source
+   *   The vertex to start from.
+   *
+   * @param out_levels
+   *   Must have `graph.num_vertices` elements, receives the number of edges on the
+   *   shortest path from \p source to each vertex or -1 for unreachable vertices.
+   *
+   * @param options
+   *   Tuning parameters.
+   *
+   * @return
+   *   The number of vertices reached, including \p source.
+   */
+  std::size_t ParallelBFS(const CSRGraph& graph, const std::uint32_t source, std::int32_t* const out_levels, const BFSOptions& options = {});
+}  // namespace Job
+
+#endif  // JOB_GRAPH_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,414 @@
+/******************************************************************************/
+/*!
+ * @file   job_hash_map.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Fixed capacity, insert only, concurrent hash map for building lookup
+ *   tables from inside parallel algorithms.
+ *
+ *   Open addressing with linear probing, a slot is claimed with a single
+ *   CAS on its state word which also holds a tag of the key's hash so that
+ *   probes rarely have to touch (or wait on) keys that cannot match.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_HASH_MAP_HPP
+#define JOB_HASH_MAP_HPP
+
+#include "job_api.hpp"           // ParallelFor, TaskSubmitAndWait, PauseProcessor, NumWorkers
+#include "job_worker_local.hpp"  // WorkerLocal
+
+#include <algorithm>   // min
+#include <atomic>      // atomic<T>
+#include <cstddef>     // size_t
+#include <cstdint>     // uint32_t, uint64_t
+#include <functional>  // hash, equal_to
+#include <memory>      // unique_ptr
+#include <new>         // placement new
+#include <utility>     // pair
+#include <vector>      // vector
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   Hash map supporting concurrent `Insert` and `Find` from any thread without locks.
+   *
+   *   All storage is allocated up front, elements can not be removed
+   *   individually and values are never moved once inserted so pointers
+   *   returned from `Insert` and `Find` are stable until `Clear`.
+   *
+   * @tparam K
+   *   Key type, must be copy constructible.
+   *
+   * @tparam V
+   *   Value type, must be copy constructible.
+   *   Concurrent modification of an inserted value is up to the caller (use atomics in `V`).
+   *
+   * @tparam Hash
+   *   Hash function object for `K`.
+   *
+   * @tparam KeyEqual
+   *   Equality function object for `K`.
+   */
+  template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+  class ConcurrentHashMap
+  {
+   public:
+    using size_type = std::size_t;
+
+    /*!
+     * @brief
+     *   The number of input elements each task of `BulkInsert` covers.
+     */
+    static constexpr size_type k_BulkInsertChunkSize = 16384u;
+
+   private:
+    // State word layout: 0 is empty, otherwise `(tag << 2) | k_SlotBusy or k_SlotFull`.
+    static constexpr std::uint32_t k_SlotEmpty = 0u;
+    static constexpr std::uint32_t k_SlotBusy  = 1u;
+    static constexpr std::uint32_t k_SlotFull  = 2u;
+    static constexpr std::uint32_t k_SlotFlags = 3u;
+
+    struct Slot
+    {
+      std::atomic<std::uint32_t> state{k_SlotEmpty};
+      alignas(K) unsigned char key_storage[sizeof(K)];
+      alignas(V) unsigned char value_storage[sizeof(V)];
+
+      K* Key() noexcept { return reinterpret_cast<K*>(key_storage); }
+      V* Value() noexcept { return reinterpret_cast<V*>(value_storage); }
+    };
+
+    struct BulkItem
+    {
+      std::uint64_t hash;
+      size_type     index;
+    };
+
+    using BulkShards = std::vector<std::vector<BulkItem>>;
+
+   private:
+    std::unique_ptr<Slot[]> m_Slots;
+    size_type               m_Capacity;
+    size_type               m_CapacityMask;
+    unsigned                m_CapacityBits;
+    Hash                    m_Hash;
+    KeyEqual                m_KeyEqual;
+
+   public:
+    /*!
+     * @brief
+     *   Allocates a table able to hold \p max_elements while keeping the load factor at or under one half.
+     *
+     * @param max_elements
+     *   The most elements that will be inserted.
+     */
+    explicit ConcurrentHashMap(const size_type max_elements, const Hash& hash = Hash{}, const KeyEqual& key_equal = KeyEqual{}) :
+      m_Slots{},
+      m_Capacity{1u},
+      m_CapacityMask{0u},
+      m_CapacityBits{0u},
+      m_Hash{hash},
+      m_KeyEqual{key_equal}
+    {
+      while (m_Capacity < max_elements * 2u || m_Capacity < 2u)
+      {
+        m_Capacity <<= 1u;
+        ++m_CapacityBits;
+      }
+
+      m_CapacityMask = m_Capacity - 1u;
+      m_Slots.reset(new Slot[m_Capacity]);
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap& rhs)            = delete;
+    ConcurrentHashMap(ConcurrentHashMap&& rhs)                 = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap& rhs) = delete;
+    ConcurrentHashMap& operator=(ConcurrentHashMap&& rhs)      = delete;
+
+    ~ConcurrentHashMap()
+    {
+      Clear();
+    }
+
+    /*!
+     * @brief
+     *   The number of slots in the table.
+     */
+    size_type Capacity() const noexcept
+    {
+      return m_Capacity;
+    }
+
+    /*!
+     * @brief
+     *   Inserts \p key mapped to \p value if \p key is not already in the map.
+     *
+     *   Safe to call concurrently with `Insert`, `BulkInsert` and `Find`.
+     *
+     * @return
+     *   The value mapped to \p key and whether it was newly inserted,
+     *   `{nullptr, false}` if the key was not found and the table is full.
+     */
+    std::pair<V*, bool> Insert(const K& key, const V& value)
+    {
+      return insertHashed(mixHash(m_Hash(key)), key, value);
+    }
+
+    /*!
+     * @brief
+     *   Looks up the value mapped to \p key.
+     *
+     *   Safe to call concurrently with `Insert` and `BulkInsert`,
+     *   an insert of \p key still in progress is not found.
+     *
+     * @return
+     *   The value mapped to \p key, nullptr if there is none.
+     */
+    V* Find(const K& key) const
+    {
+      const std::uint64_t hash  = mixHash(m_Hash(key));
+      const std::uint32_t full  = tagOf(hash) | k_SlotFull;
+      size_type           index = homeIndex(hash);
+
+      for (size_type num_probes = 0u; num_probes < m_Capacity; ++num_probes)
+      {
+        Slot&               slot  = m_Slots[index];
+        const std::uint32_t state = slot.state.load(std::memory_order_acquire);
+
+        if (state == k_SlotEmpty)
+        {
+          break;
+        }
+
+        if (state == full && m_KeyEqual(*slot.Key(), key))
+        {
+          return slot.Value();
+        }
+
+        index = (index + 1u) & m_CapacityMask;
+      }
+
+      return nullptr;
+    }
+
+    /*!
+     * @brief
+     *   Inserts `keys[i]` mapped to `values[i]` for each i in [0, count).
+     *
+     *   Each worker first sorts its share of the input into one shard per
+     *   contiguous region of the table then every region is filled by its own
+     *   task, so the threads write to disjoint parts of the table instead of
+     *   all contending over random slots.
+     *
+     *   When a key appears more than once which of its values is kept is unspecified.
+     *
+     *   Blocks until finished.
+     *
+     * @return
+     *   The number of keys newly inserted.
+     */
+    size_type BulkInsert(const K* const keys, const V* const values, const size_type count)
+    {
+      if (count == 0u)
+      {
+        return 0u;
+      }
+
+      unsigned shard_bits = 0u;
+
+      while (shard_bits < m_CapacityBits && (size_type(1u) << shard_bits) < size_type(NumWorkers()) * 4u)
+      {
+        ++shard_bits;
+      }
+
+      const size_type         num_shards = size_type(1u) << shard_bits;
+      const size_type         num_chunks = (count + k_BulkInsertChunkSize - 1u) / k_BulkInsertChunkSize;
+      WorkerLocal<BulkShards> worker_shards{BulkShards(num_shards)};
+
+      TaskSubmitAndWait(ParallelFor(
+       size_type(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [this, keys, count, shard_bits, &worker_shards](Task* const, const size_type chunk) {
+         const size_type chunk_begin = chunk * k_BulkInsertChunkSize;
+         const size_type chunk_end   = std::min(count, chunk_begin + k_BulkInsertChunkSize);
+         BulkShards&     shards      = worker_shards.Local();
+
+         for (size_type i = chunk_begin; i < chunk_end; ++i)
+         {
+           const std::uint64_t hash = mixHash(m_Hash(keys[i]));
+
+           shards[homeIndex(hash) >> (m_CapacityBits - shard_bits)].push_back(BulkItem{hash, i});
+         }
+       }));
+
+      std::vector<BulkShards*> all_shards;
+      worker_shards.ForEach([&all_shards](BulkShards& shards) { all_shards.push_back(&shards); });
+
+      std::atomic<size_type> num_inserted{0u};
+
+      // NOTE(SR): Probing may run off the end of a region into the next one, that is still correct since slots are claimed atomically.
+      TaskSubmitAndWait(ParallelFor(
+       size_type(0u), num_shards, Splitter::MaxItemsPerTask(1u), [this, keys, values, &all_shards, &num_inserted](Task* const, const size_type shard) {
+         size_type shard_inserted = 0u;
+
+         for (BulkShards* const shards : all_shards)
+         {
+           for (const BulkItem& item : (*shards)[shard])
+           {
+             shard_inserted += insertHashed(item.hash, keys[item.index], values[item.index]).second;
+           }
+         }
+
+         num_inserted.fetch_add(shard_inserted, std::memory_order_relaxed);
+       }));
+
+      return num_inserted.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief
+     *   Calls `fn(const K& key, V& value)` for every element.
+     *
+     *   Elements inserted concurrently may or may not be visited.
+     */
+    template<typename F>
+    void ForEach(F&& fn)
+    {
+      for (size_type i = 0u; i < m_Capacity; ++i)
+      {
+        Slot& slot = m_Slots[i];
+
+        if ((slot.state.load(std::memory_order_acquire) & k_SlotFlags) == k_SlotFull)
+        {
+          fn(const_cast<const K&>(*slot.Key()), *slot.Value());
+        }
+      }
+    }
+
+    /*!
+     * @brief
+     *   Counts the elements, linear in `Capacity`.
+     */
+    size_type Size() const
+    {
+      size_type size = 0u;
+
+      for (size_type i = 0u; i < m_Capacity; ++i)
+      {
+        size += (m_Slots[i].state.load(std::memory_order_acquire) & k_SlotFlags) == k_SlotFull;
+      }
+
+      return size;
+    }
+
+    /*!
+     * @brief
+     *   Destroys every element.
+     *
+     * @warning
+     *   Must not be called while other threads may still be accessing the map.
+     */
+    void Clear()
+    {
+      for (size_type i = 0u; i < m_Capacity; ++i)
+      {
+        Slot& slot = m_Slots[i];
+
+        if ((slot.state.load(std::memory_order_relaxed) & k_SlotFlags) == k_SlotFull)
+        {
+          slot.Value()->~V();
+          slot.Key()->~K();
+        }
+
+        slot.state.store(k_SlotEmpty, std::memory_order_relaxed);
+      }
+    }
+
+   private:
+    // Fibonacci hashing, spreads identity hashes (`std::hash<int>`) over the top bits used for the home slot.
+    static std::uint64_t mixHash(const std::size_t hash) noexcept
+    {
+      return std::uint64_t(hash) * 0x9E3779B97F4A7C15ull;
+    }
+
+    // The low bits of the mixed hash, independent of the top bits that picked the slot.
+    static std::uint32_t tagOf(const std::uint64_t hash) noexcept
+    {
+      return std::uint32_t(hash) & ~k_SlotFlags;
+    }
+
+    size_type homeIndex(const std::uint64_t hash) const noexcept
+    {
+      return m_CapacityBits ? size_type(hash >> (64u - m_CapacityBits)) : 0u;
+    }
+
+    std::pair<V*, bool> insertHashed(const std::uint64_t hash, const K& key, const V& value)
+    {
+      const std::uint32_t tag   = tagOf(hash);
+      size_type           index = homeIndex(hash);
+
+      for (size_type num_probes = 0u; num_probes < m_Capacity; ++num_probes)
+      {
+        Slot&         slot  = m_Slots[index];
+        std::uint32_t state = slot.state.load(std::memory_order_acquire);
+
+        if (state == k_SlotEmpty)
+        {
+          if (slot.state.compare_exchange_strong(state, tag | k_SlotBusy, std::memory_order_acquire, std::memory_order_acquire))
+          {
+            new (slot.key_storage) K(key);
+            new (slot.value_storage) V(value);
+            slot.state.store(tag | k_SlotFull, std::memory_order_release);
+
+            return {slot.Value(), true};
+          }
+        }
+
+        // Only a slot with the same tag can hold this key, it is worth waiting for its key to be published.
+        while (state == (tag | k_SlotBusy))
+        {
+          PauseProcessor();
+          state = slot.state.load(std::memory_order_acquire);
+        }
+
+        if (state == (tag | k_SlotFull) && m_KeyEqual(*slot.Key(), key))
+        {
+          return {slot.Value(), false};
+        }
+
+        index = (index + 1u) & m_CapacityMask;
+      }
+
+      return {nullptr, false};
+    }
+  };
+}  // namespace Job
+
+#endif  // JOB_HASH_MAP_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,138 @@
+/******************************************************************************/
+/*!
+ * @file   job_numeric.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel reductions over large float arrays.
+ *
+ *   Each chunk is reduced by a vectorized kernel (SSE2 / AVX2 picked at
+ *   runtime on x86-64, NEON on AArch64) into its own slot of a partials
+ *   array, the caller folds the partials in chunk order once every chunk
+ *   has finished so there is one wait instead of a join per tree level
+ *   and the results do not depend on the number of threads.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_NUMERIC_HPP
+#define JOB_NUMERIC_HPP
+
+#include <cstddef>  // size_t
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   The number of elements each task of the numeric kernels covers.
+   */
+  static constexpr std::size_t k_NumericChunkSize = 65536u;
+
+  /*!
+   * @brief
+   *   The instruction set the numeric kernels were dispatched to on this CPU.
+   */
+  enum class SimdLevel
+  {
+    SCALAR,
+    SSE2,
+    AVX2,
+    NEON,
+  };
+
+  struct MinMaxResult
+  {
+    float min;  //!< +infinity for an empty array.
+    float max;  //!< -infinity for an empty array.
+  };
+
+  struct ArgMinResult
+  {
+    float       value;  //!< +infinity for an empty array.
+    std::size_t index;  //!< Lowest index holding `value`, the element count for an empty array.
+  };
+
+  /*!
+   * @brief
+   *   The instruction set `ParallelSum`, `ParallelMinMax` and `ParallelArgMin` use.
+   */
+  SimdLevel NumericSimdLevel() noexcept;
+
+  /*!
+   * @brief
+   *   Sums \p data, each chunk is summed in float lanes and the chunk totals in double.
+   *
+   *   Blocks until finished.
+   *
+   * @param data
+   *   The elements to sum.
+   *
+   * @param count
+   *   The number of elements in \p data.
+   *
+   * @return
+   *   The sum, the same for any number of workers.
+   */
+  double ParallelSum(const float* const data, const std::size_t count);
+
+  /*!
+   * @brief
+   *   Finds the smallest and largest element of \p data, which must not contain NaNs.
+   *
+   *   Blocks until finished.
+   *
+   * @param data
+   *   The elements to search.
+   *
+   * @param count
+   *   The number of elements in \p data.
+   *
+   * @return
+   *   The smallest and largest element.
+   */
+  MinMaxResult ParallelMinMax(const float* const data, const std::size_t count);
+
+  /*!
+   * @brief
+   *   Finds the first smallest element of \p data, which must not contain NaNs.
+   *
+   *   Blocks until finished.
+   *
+   * @param data
+   *   The elements to search.
+   *
+   * @param count
+   *   The number of elements in \p data.
+   *
+   * @return
+   *   The smallest element and the lowest index it is at.
+   */
+  ArgMinResult ParallelArgMin(const float* const data, const std::size_t count);
+}  // namespace Job
+
+#endif  // JOB_NUMERIC_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
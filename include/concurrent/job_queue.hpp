@@ -233,8 +233,20 @@ namespace Job
     FAILED_SIZE,  //!< Returned from Push, Pop and Steal
   };
 
+  namespace detail
+  {
+    /*!
+     * @brief
+     *   The expensive half of an asymmetric fence, acts as if every running thread
+     *   of the process executed a full fence, so those threads only need a compiler barrier.
+     *   Only valid once `Job::Initialize` has set up `WorkStealing::ASYMMETRIC_FENCES`.
+     */
+    void asymmetricHeavyFence() noexcept;
+  }  // namespace detail
+
   // [Dynamic Circular Work-Stealing Deque](https://www.dre.vanderbilt.edu/~schmidt/PDF/work-stealing-dequeue.pdf)
   // [Correct and Efficient Work-Stealing for Weak Memory Models](https://fzn.fr/readings/ppopp13.pdf)
+  // [Asymmetric fences, see `folly::asymmetricHeavyBarrier`](https://github.com/facebook/folly/blob/main/folly/synchronization/AsymmetricThreadFence.h)
   template<typename T>
   class SPMCDeque
   {
@@ -257,19 +269,21 @@ namespace Job
     alignas(k_FalseSharingPadSize) AtomicT* m_Data;
     size_type m_Capacity;
     size_type m_CapacityMask;
+    bool      m_AsymmetricFence;  //!< Pop uses a compiler barrier and Steal calls `detail::asymmetricHeavyFence`.
 
    public:
     SPMCDeque()  = default;
     ~SPMCDeque() = default;
 
     // NOTE(SR): Not thread safe.
-    void Initialize(AtomicT* const memory_backing, const size_type capacity) noexcept
+    void Initialize(AtomicT* const memory_backing, const size_type capacity, const bool asymmetric_fence = false) noexcept
     {
-      m_ProducerIndex = 0;
-      m_ConsumerIndex = 0;
-      m_Data          = memory_backing;
-      m_Capacity      = capacity;
-      m_CapacityMask  = capacity - 1;
+      m_ProducerIndex   = 0;
+      m_ConsumerIndex   = 0;
+      m_Data            = memory_backing;
+      m_Capacity        = capacity;
+      m_CapacityMask    = capacity - 1;
+      m_AsymmetricFence = asymmetric_fence;
 
       JobAssert((m_Capacity & m_CapacityMask) == 0, "Capacity must be a power of 2.");
     }
@@ -307,7 +321,17 @@ namespace Job
       // `m_ProducerIndex` can only be written to by this thread
       // so first reserve a slot then we read what the other threads have to say.
       //
-      std::atomic_thread_fence(std::memory_order_seq_cst);
+      // With an asymmetric fence the thief's heavy fence orders this store
+      // for us, the compiler just must not move the load above it.
+      //
+      if (m_AsymmetricFence)
+      {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+      }
+      else
+      {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
 
       size_type consumer_index = m_ConsumerIndex.load(std::memory_order_relaxed);
 
@@ -341,8 +365,23 @@ namespace Job
     {
       size_type read_index = m_ConsumerIndex.load(std::memory_order_acquire);
 
-      // Must fully read `m_ConsumerIndex` before we read the producer owned `m_ProducerIndex`.
-      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_AsymmetricFence)
+      {
+        // NOTE(SR):
+        //   The heavy fence is far more expensive than a full fence, so skip it
+        //   when the deque looks empty, failing to steal is always allowed.
+        if (read_index >= m_ProducerIndex.load(std::memory_order_relaxed))
+        {
+          return SPMCDequeStatus::FAILED_SIZE;
+        }
+
+        detail::asymmetricHeavyFence();
+      }
+      else
+      {
+        // Must fully read `m_ConsumerIndex` before we read the producer owned `m_ProducerIndex`.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
 
       const size_type write_index = m_ProducerIndex.load(std::memory_order_acquire);
 
@@ -372,6 +411,82 @@ namespace Job
     }
   };
 
+  // [Scheduling Parallel Programs by Work Stealing with Private Deques](https://www.chargueraud.org/research/2013/ppopp/full.pdf)
+  //
+  // NOTE(SR):
+  //   Not thread safe, only the owning thread may touch it so none of the
+  //   operations need fences or atomics, work leaves the deque by the owner
+  //   calling `PopOldest` when it answers a steal request.
+  template<typename T>
+  class PrivateDeque
+  {
+   public:
+    using size_type = std::size_t;
+
+   private:
+    T*        m_Data;
+    size_type m_Head;  //!< Index of the oldest element.
+    size_type m_Tail;  //!< One past the index of the newest element.
+    size_type m_CapacityMask;
+
+   public:
+    PrivateDeque()  = default;
+    ~PrivateDeque() = default;
+
+    void Initialize(T* const memory_backing, const size_type capacity) noexcept
+    {
+      m_Data         = memory_backing;
+      m_Head         = 0u;
+      m_Tail         = 0u;
+      m_CapacityMask = capacity - 1u;
+
+      JobAssert((capacity & m_CapacityMask) == 0u, "Capacity must be a power of 2.");
+    }
+
+    bool IsEmpty() const noexcept { return m_Head == m_Tail; }
+
+    bool Push(const T& value)
+    {
+      if (m_Tail - m_Head > m_CapacityMask)
+      {
+        return false;
+      }
+
+      *ElementAt(m_Tail++) = value;
+      return true;
+    }
+
+    // Newest element.
+    bool Pop(T* const out_value)
+    {
+      if (IsEmpty())
+      {
+        return false;
+      }
+
+      *out_value = std::move(*ElementAt(--m_Tail));
+      return true;
+    }
+
+    // Oldest element, the one given away to thieves since it likely represents the most work.
+    bool PopOldest(T* const out_value)
+    {
+      if (IsEmpty())
+      {
+        return false;
+      }
+
+      *out_value = std::move(*ElementAt(m_Head++));
+      return true;
+    }
+
+   private:
+    T* ElementAt(const size_type index) const noexcept
+    {
+      return m_Data + (index & m_CapacityMask);
+    }
+  };
+
   // https://www.youtube.com/watch?v=_qaKkHuHYE0&ab_channel=CppCon
   class MPMCQueue
   {
@@ -0,0 +1,350 @@
+/******************************************************************************/
+/*!
+ * @file   job_random.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel algorithms that consume random numbers.
+ *
+ *   Work is cut into fixed size chunks and each chunk derives its own
+ *   `RandomStream` from the user's seed and the chunk's index so the
+ *   results do not depend on which worker ended up running which chunk.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_RANDOM_HPP
+#define JOB_RANDOM_HPP
+
+#include "job_api.hpp"  // RandomStream, ParallelFor
+
+#include <algorithm>  // copy_n, move
+#include <cstddef>    // size_t
+#include <cstdint>    // uint8_t, uint32_t, uint64_t
+#include <iterator>   // iterator_traits
+#include <memory>     // unique_ptr
+#include <utility>    // exchange, swap, move
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   The number of items each independently seeded chunk covers.
+   *   Changing this changes the output of every algorithm in this file.
+   */
+  static constexpr std::size_t k_RandomChunkSize = 16384u;
+
+  /*!
+   * @brief
+   *   Fills \p out with random numbers, chunk `i` is generated by `RandomStream(seed, i)`
+   *   so the same seed always produces the same output.
+   *
+   * @param out
+   *   The array to write to.
+   *
+   * @param count
+   *   The number of elements in the \p out array.
+   *
+   * @param seed
+   *   The seed shared by all chunks.
+   *
+   * @param parent
+   *   Parent task to add this task as a child of.
+   *
+   * @return
+   *   The new task holding the work, must be submitted.
+   */
+  inline Task* ParallelGenerateRandom(std::uint32_t* const out, const std::size_t count, const std::uint64_t seed, Task* const parent = nullptr)
+  {
+    const std::size_t num_chunks = (count + k_RandomChunkSize - 1u) / k_RandomChunkSize;
+
+    return ParallelFor(
+     std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [out, count, seed](Task* const, const std::size_t chunk_index) {
+       const std::size_t chunk_start = chunk_index * k_RandomChunkSize;
+       const std::size_t chunk_count = count - chunk_start < k_RandomChunkSize ? count - chunk_start : k_RandomChunkSize;
+
+       RandomStream(seed, chunk_index).Fill(out + chunk_start, chunk_count);
+     },
+     parent);
+  }
+
+  namespace detail
+  {
+    static constexpr std::size_t k_RandomMaxBuckets = 256u;
+
+    // NOTE(SR):
+    //   Assigns every item to a uniformly random bucket then computes where each
+    //   chunk's items of each bucket land when the buckets are laid out back to back.
+    //   Chunk `c` draws from stream `c`, bucket `b` later draws from stream `num_chunks + b`.
+    //
+    //   A uniform bucket assignment followed by a uniform shuffle of each bucket is a uniform
+    //   shuffle of the whole range. Whole buckets plus a uniform subset of the next one are a
+    //   uniform sample, since every bucket's size and membership are already uniformly random.
+    struct RandomBuckets
+    {
+      std::size_t                     num_items;
+      std::size_t                     num_chunks;
+      std::size_t                     num_buckets;
+      std::unique_ptr<std::uint8_t[]> item_bucket;   //!< [item] -> bucket.
+      std::unique_ptr<std::size_t[]>  chunk_offset;  //!< [chunk * num_buckets + bucket] -> output position of the chunk's first item in the bucket.
+      std::unique_ptr<std::size_t[]>  bucket_start;  //!< [bucket] -> output position of the bucket, has `num_buckets + 1` entries.
+
+      RandomBuckets(const std::size_t num_items, const std::uint64_t seed) :
+        num_items{num_items},
+        num_chunks{(num_items + k_RandomChunkSize - 1u) / k_RandomChunkSize},
+        num_buckets{num_chunks < k_RandomMaxBuckets ? (num_chunks ? num_chunks : 1u) : k_RandomMaxBuckets},
+        item_bucket{new std::uint8_t[num_items]},
+        chunk_offset{new std::size_t[num_chunks * num_buckets]()},
+        bucket_start{new std::size_t[num_buckets + 1u]}
+      {
+        std::uint8_t* const buckets     = item_bucket.get();
+        std::size_t* const  counts      = chunk_offset.get();
+        const std::size_t   bucket_size = num_buckets;
+
+        TaskSubmitAndWait(ParallelFor(
+         std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [=](Task* const, const std::size_t chunk_index) {
+           const std::size_t  chunk_start = chunk_index * k_RandomChunkSize;
+           const std::size_t  chunk_end   = num_items - chunk_start < k_RandomChunkSize ? num_items : chunk_start + k_RandomChunkSize;
+           std::size_t* const chunk_count = counts + chunk_index * bucket_size;
+           RandomStream       rng         = {seed, chunk_index};
+
+           for (std::size_t i = chunk_start; i < chunk_end; ++i)
+           {
+             const std::uint32_t bucket = rng.NextBounded(std::uint32_t(bucket_size));
+
+             buckets[i] = std::uint8_t(bucket);
+             ++chunk_count[bucket];
+           }
+         }));
+
+        std::size_t running_offset = 0u;
+
+        for (std::size_t bucket = 0u; bucket < num_buckets; ++bucket)
+        {
+          bucket_start[bucket] = running_offset;
+
+          for (std::size_t chunk = 0u; chunk < num_chunks; ++chunk)
+          {
+            std::size_t& count = counts[chunk * num_buckets + bucket];
+
+            running_offset += std::exchange(count, running_offset);
+          }
+        }
+
+        bucket_start[num_buckets] = running_offset;
+      }
+
+      RandomStream BucketStream(const std::uint64_t seed, const std::size_t bucket) const noexcept
+      {
+        return RandomStream(seed, num_chunks + bucket);
+      }
+
+      // Calls `fn(item_index, output_position)` for every item with a bucket less than or equal to `max_bucket`.
+      template<typename F>
+      void Scatter(const std::size_t max_bucket, const F& fn) const
+      {
+        const std::uint8_t* const buckets     = item_bucket.get();
+        const std::size_t* const  offsets     = chunk_offset.get();
+        const std::size_t         bucket_size = num_buckets;
+        const std::size_t         total_items = num_items;
+        const F* const            scatter_fn  = &fn;
+
+        TaskSubmitAndWait(ParallelFor(
+         std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [=](Task* const, const std::size_t chunk_index) {
+           std::size_t       positions[k_RandomMaxBuckets];
+           const std::size_t chunk_start = chunk_index * k_RandomChunkSize;
+           const std::size_t chunk_end   = total_items - chunk_start < k_RandomChunkSize ? total_items : chunk_start + k_RandomChunkSize;
+
+           std::copy_n(offsets + chunk_index * bucket_size, bucket_size, positions);
+
+           for (std::size_t i = chunk_start; i < chunk_end; ++i)
+           {
+             const std::size_t bucket = buckets[i];
+
+             if (bucket <= max_bucket)
+             {
+               (*scatter_fn)(i, positions[bucket]++);
+             }
+           }
+         }));
+      }
+    };
+  }  // namespace detail
+
+  /*!
+   * @brief
+   *   Randomly shuffles [first, last), the same seed always produces the same permutation.
+   *
+   *   Items are scattered into random buckets in parallel and then each bucket is
+   *   Fisher-Yates shuffled in parallel, see `k_RandomChunkSize` for how the work is cut up.
+   *   Blocks until finished.
+   *
+   * @tparam RandomIt
+   *   Random access iterator whose value type is default constructible and move assignable.
+   *
+   * @param first
+   *   Start of the range to shuffle.
+   *
+   * @param last
+   *   End of the range to shuffle.
+   *
+   * @param seed
+   *   Selects the permutation.
+   */
+  template<typename RandomIt>
+  void ParallelShuffle(const RandomIt first, const RandomIt last, const std::uint64_t seed)
+  {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t num_items = std::size_t(last - first);
+
+    if (num_items < 2u)
+    {
+      return;
+    }
+
+    const detail::RandomBuckets  buckets = {num_items, seed};
+    std::unique_ptr<ValueType[]> scratch{new ValueType[num_items]};
+    ValueType* const             scratch_data = scratch.get();
+    const std::size_t* const     bucket_start = buckets.bucket_start.get();
+    const detail::RandomBuckets* buckets_ptr  = &buckets;
+
+    buckets.Scatter(buckets.num_buckets, [first, scratch_data](const std::size_t item, const std::size_t position) {
+      scratch_data[position] = std::move(first[item]);
+    });
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), buckets.num_buckets, Splitter::MaxItemsPerTask(1u), [=](Task* const, const std::size_t bucket) {
+       const std::size_t bucket_bgn = bucket_start[bucket];
+       const std::size_t bucket_end = bucket_start[bucket + 1u];
+       RandomStream      rng        = buckets_ptr->BucketStream(seed, bucket);
+
+       for (std::size_t i = bucket_end - bucket_bgn; i > 1u; --i)
+       {
+         const std::size_t j = rng.NextBounded(std::uint32_t(i));
+
+         std::swap(scratch_data[bucket_bgn + i - 1u], scratch_data[bucket_bgn + j]);
+       }
+
+       std::move(scratch_data + bucket_bgn, scratch_data + bucket_end, first + bucket_bgn);
+     }));
+  }
+
+  /*!
+   * @brief
+   *   Copies a uniform random sample (without replacement) of \p sample_size items
+   *   from [first, last) into \p out, the same seed always produces the same sample.
+   *
+   *   Only the buckets that contribute to the sample are gathered and only the last
+   *   partially used bucket is shuffled. The order of the items in \p out is unspecified.
+   *   Blocks until finished.
+   *
+   * @tparam RandomIt
+   *   Random access iterator whose value type is copy constructible.
+   *
+   * @tparam OutIt
+   *   Random access iterator to at least \p sample_size writable items.
+   *
+   * @param first
+   *   Start of the range to sample from.
+   *
+   * @param last
+   *   End of the range to sample from.
+   *
+   * @param out
+   *   Where the sampled items are written to.
+   *
+   * @param sample_size
+   *   The number of items to sample, clamped to `last - first`.
+   *
+   * @param seed
+   *   Selects the sample.
+   *
+   * @return
+   *   The number of items written to \p out.
+   */
+  template<typename RandomIt, typename OutIt>
+  std::size_t ParallelSample(const RandomIt first, const RandomIt last, const OutIt out, std::size_t sample_size, const std::uint64_t seed)
+  {
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t num_items = std::size_t(last - first);
+
+    if (sample_size > num_items)
+    {
+      sample_size = num_items;
+    }
+
+    if (sample_size == 0u)
+    {
+      return 0u;
+    }
+
+    const detail::RandomBuckets buckets      = {num_items, seed};
+    const std::size_t* const    bucket_start = buckets.bucket_start.get();
+    std::size_t                 last_bucket  = 0u;
+
+    while (bucket_start[last_bucket + 1u] < sample_size)
+    {
+      ++last_bucket;
+    }
+
+    // Every bucket before `last_bucket` is taken in full, `last_bucket` is partially taken.
+
+    const std::size_t            partial_start = bucket_start[last_bucket];
+    const std::size_t            partial_size  = bucket_start[last_bucket + 1u] - partial_start;
+    const std::size_t            partial_take  = sample_size - partial_start;
+    std::unique_ptr<ValueType[]> partial{new ValueType[partial_size]};
+    ValueType* const             partial_data = partial.get();
+
+    buckets.Scatter(last_bucket, [first, out, partial_data, partial_start](const std::size_t item, const std::size_t position) {
+      if (position < partial_start)
+      {
+        out[position] = first[item];
+      }
+      else
+      {
+        partial_data[position - partial_start] = first[item];
+      }
+    });
+
+    RandomStream rng = buckets.BucketStream(seed, last_bucket);
+
+    for (std::size_t i = 0u; i < partial_take; ++i)
+    {
+      const std::size_t j = i + rng.NextBounded(std::uint32_t(partial_size - i));
+
+      std::swap(partial_data[i], partial_data[j]);
+      out[partial_start + i] = std::move(partial_data[i]);
+    }
+
+    return sample_size;
+  }
+}  // namespace Job
+
+#endif  // JOB_RANDOM_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
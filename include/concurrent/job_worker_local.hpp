@@ -0,0 +1,247 @@
+/******************************************************************************/
+/*!
+ * @file   job_worker_local.hpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Enumerable per-worker storage for "one accumulator per worker,
+ *   combine at the end" style reductions.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#ifndef JOB_WORKER_LOCAL_HPP
+#define JOB_WORKER_LOCAL_HPP
+
+#include "job_api.hpp"     // CurrentWorker, NumWorkers, WorkerID
+#include "job_assert.hpp"  // JobAssert
+#include "job_queue.hpp"   // k_FalseSharingPadSize
+
+#include <cstddef>  // size_t
+#include <memory>   // unique_ptr
+#include <new>      // placement new
+#include <utility>  // forward, move
+
+namespace Job
+{
+  /*!
+   * @brief
+   *   One lazily constructed `T` per worker, each on its own cache line(s) to avoid false sharing.
+   *
+   *   A slot exists for every `WorkerID` the system hands out which includes
+   *   the main thread, the owned worker threads and any user threads registered
+   *   through `Job::SetupUserThread`.
+   *
+   *   `Local` may be called concurrently from any registered thread,
+   *   `Combine`, `ForEach` and `Clear` must not be called while
+   *   other threads may still be calling `Local`.
+   *
+   * @tparam T
+   *   The type stored per worker, must be copy constructible.
+   *
+   * @warning
+   *   Must be constructed after `Job::Initialize` and destroyed before `Job::Shutdown`.
+   */
+  template<typename T>
+  class WorkerLocal
+  {
+   private:
+    static constexpr std::size_t k_SlotAlignment = alignof(T) > k_FalseSharingPadSize ? alignof(T) : k_FalseSharingPadSize;
+
+    struct alignas(k_SlotAlignment) Slot
+    {
+      alignas(T) unsigned char storage[sizeof(T)];
+      bool is_constructed = false;
+
+      T*       Get() noexcept { return reinterpret_cast<T*>(storage); }
+      const T* Get() const noexcept { return reinterpret_cast<const T*>(storage); }
+    };
+
+   private:
+    std::unique_ptr<Slot[]> m_Slots;
+    WorkerID                m_NumSlots;
+    T                       m_Exemplar;
+
+   public:
+    /*!
+     * @brief
+     *   Each worker's `T` will be default constructed on first use.
+     */
+    WorkerLocal() :
+      WorkerLocal(T{})
+    {
+    }
+
+    /*!
+     * @brief
+     *   Each worker's `T` will be copy constructed from \p exemplar on first use.
+     *
+     * @param exemplar
+     *   The initial value of each worker's local `T`.
+     */
+    explicit WorkerLocal(const T& exemplar) :
+      m_Slots{new Slot[NumWorkers()]},
+      m_NumSlots{NumWorkers()},
+      m_Exemplar{exemplar}
+    {
+    }
+
+    WorkerLocal(const WorkerLocal& rhs)            = delete;
+    WorkerLocal(WorkerLocal&& rhs)                 = delete;
+    WorkerLocal& operator=(const WorkerLocal& rhs) = delete;
+    WorkerLocal& operator=(WorkerLocal&& rhs)      = delete;
+
+    ~WorkerLocal()
+    {
+      Clear();
+    }
+
+    /*!
+     * @brief
+     *   The number of per worker slots, each slot may or may not be constructed yet.
+     */
+    WorkerID NumSlots() const noexcept
+    {
+      return m_NumSlots;
+    }
+
+    /*!
+     * @brief
+     *   Returns the calling worker's `T`, constructing it if this is the first access.
+     *
+     * @return
+     *   The calling worker's `T`.
+     *
+     * @warning
+     *   Must only be called from a thread registered with the job system.
+     */
+    T& Local()
+    {
+      const WorkerID worker_id = CurrentWorker();
+
+      JobAssert(worker_id < m_NumSlots, "WorkerLocal was created with fewer slots than there are workers.");
+
+      Slot& slot = m_Slots[worker_id];
+
+      if (!slot.is_constructed)
+      {
+        new (slot.storage) T(m_Exemplar);
+        slot.is_constructed = true;
+      }
+
+      return *slot.Get();
+    }
+
+    /*!
+     * @brief
+     *   Calls \p fn on each constructed worker local `T`, in `WorkerID` order.
+     *
+     * @tparam F
+     *   Must be callable like: fn(T& value)
+     */
+    template<typename F>
+    void ForEach(F&& fn)
+    {
+      for (WorkerID i = 0u; i < m_NumSlots; ++i)
+      {
+        Slot& slot = m_Slots[i];
+
+        if (slot.is_constructed)
+        {
+          fn(*slot.Get());
+        }
+      }
+    }
+
+    /*!
+     * @brief
+     *   Folds all constructed worker local `T`s together in `WorkerID` order.
+     *
+     * @tparam BinaryOp
+     *   Must be callable like: T op(const T& lhs, const T& rhs)
+     *
+     * @return
+     *   The combined value or a copy of the exemplar if no worker has called `Local`.
+     */
+    template<typename BinaryOp>
+    T Combine(BinaryOp&& op) const
+    {
+      const Slot* const slots_end = m_Slots.get() + m_NumSlots;
+      const Slot*       slot      = m_Slots.get();
+
+      while (slot != slots_end && !slot->is_constructed)
+      {
+        ++slot;
+      }
+
+      if (slot == slots_end)
+      {
+        return m_Exemplar;
+      }
+
+      T result = *slot->Get();
+
+      for (++slot; slot != slots_end; ++slot)
+      {
+        if (slot->is_constructed)
+        {
+          result = op(result, *slot->Get());
+        }
+      }
+
+      return result;
+    }
+
+    /*!
+     * @brief
+     *   Destroys all constructed worker local `T`s, the next call to `Local` starts from the exemplar again.
+     */
+    void Clear()
+    {
+      for (WorkerID i = 0u; i < m_NumSlots; ++i)
+      {
+        Slot& slot = m_Slots[i];
+
+        if (slot.is_constructed)
+        {
+          slot.Get()->~T();
+          slot.is_constructed = false;
+        }
+      }
+    }
+  };
+
+  /*!
+   * @brief
+   *   Alias of `WorkerLocal` matching the name other task libraries use.
+   */
+  template<typename T>
+  using Combinable = WorkerLocal<T>;
+}  // namespace Job
+
+#endif  // JOB_WORKER_LOCAL_HPP
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,442 @@
+/******************************************************************************/
+/*!
+ * @file   job_bytes.cpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel kernels for very large flat buffers.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#include "concurrent/job_bytes.hpp"
+
+#include "concurrent/job_algorithms.hpp"  // ParallelReduceDeterministic
+
+#include <cstring>  // memcpy, memset
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JOB_BYTES_SSE2 1
+#include <emmintrin.h>  // _mm_stream_si128, _mm_loadu_si128, _mm_set1_epi8
+#else
+#define JOB_BYTES_SSE2 0
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define JOB_CRC32C_X86_GNU  1
+#define JOB_CRC32C_X86_MSVC 0
+#define JOB_CRC32C_ARM      0
+#include <nmmintrin.h>  // _mm_crc32_u8, _mm_crc32_u64
+#elif defined(_M_X64) && defined(_MSC_VER)
+#define JOB_CRC32C_X86_GNU  0
+#define JOB_CRC32C_X86_MSVC 1
+#define JOB_CRC32C_ARM      0
+#include <intrin.h>     // __cpuid
+#include <nmmintrin.h>  // _mm_crc32_u8, _mm_crc32_u64
+#elif defined(__ARM_FEATURE_CRC32)
+#define JOB_CRC32C_X86_GNU  0
+#define JOB_CRC32C_X86_MSVC 0
+#define JOB_CRC32C_ARM      1
+#include <arm_acle.h>  // __crc32cb, __crc32cd
+#else
+#define JOB_CRC32C_X86_GNU  0
+#define JOB_CRC32C_X86_MSVC 0
+#define JOB_CRC32C_ARM      0
+#endif
+
+namespace
+{
+  using namespace Job;
+
+#if JOB_BYTES_SSE2
+  static constexpr std::size_t k_StreamVectorSize = sizeof(__m128i);
+
+  // Bytes until `address` is aligned to a vector store.
+  static std::size_t StreamHeadSize(const void* const address, const std::size_t num_bytes)
+  {
+    const std::size_t head_size = (k_StreamVectorSize - reinterpret_cast<std::uintptr_t>(address) % k_StreamVectorSize) % k_StreamVectorSize;
+
+    return head_size < num_bytes ? head_size : num_bytes;
+  }
+
+  // NOTE(SR):
+  //   Non-temporal stores are weakly ordered, the `_mm_sfence` makes them visible
+  //   before the task's completion is published to whoever waits on it.
+
+  static void StreamCopy(unsigned char* dst, const unsigned char* src, std::size_t num_bytes)
+  {
+    const std::size_t head_size = StreamHeadSize(dst, num_bytes);
+
+    std::memcpy(dst, src, head_size);
+    dst += head_size;
+    src += head_size;
+    num_bytes -= head_size;
+
+    while (num_bytes >= k_StreamVectorSize * 4u)
+    {
+      const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + 0);
+      const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + 1);
+      const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + 2);
+      const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + 3);
+
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 0, v0);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 1, v1);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 2, v2);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 3, v3);
+
+      dst += k_StreamVectorSize * 4u;
+      src += k_StreamVectorSize * 4u;
+      num_bytes -= k_StreamVectorSize * 4u;
+    }
+
+    _mm_sfence();
+    std::memcpy(dst, src, num_bytes);
+  }
+
+  static void StreamFill(unsigned char* dst, const unsigned char value, std::size_t num_bytes)
+  {
+    const std::size_t head_size = StreamHeadSize(dst, num_bytes);
+    const __m128i     v         = _mm_set1_epi8(char(value));
+
+    std::memset(dst, value, head_size);
+    dst += head_size;
+    num_bytes -= head_size;
+
+    while (num_bytes >= k_StreamVectorSize * 4u)
+    {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 0, v);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 1, v);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 2, v);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst) + 3, v);
+
+      dst += k_StreamVectorSize * 4u;
+      num_bytes -= k_StreamVectorSize * 4u;
+    }
+
+    _mm_sfence();
+    std::memset(dst, value, num_bytes);
+  }
+#else
+  static void StreamCopy(unsigned char* const dst, const unsigned char* const src, const std::size_t num_bytes)
+  {
+    std::memcpy(dst, src, num_bytes);
+  }
+
+  static void StreamFill(unsigned char* const dst, const unsigned char value, const std::size_t num_bytes)
+  {
+    std::memset(dst, value, num_bytes);
+  }
+#endif
+
+  // CRC-32C
+
+  // Reflected Castagnoli polynomial.
+  static constexpr std::uint32_t k_Crc32cPoly = 0x82F63B78u;
+
+  using Crc32cUpdateFn = std::uint32_t (*)(std::uint32_t crc, const unsigned char* data, std::size_t num_bytes);
+
+  // Slicing-by-8 tables, `table[k][b]` is the CRC of byte `b` followed by `k` zero bytes.
+  struct Crc32cTables
+  {
+    std::uint32_t table[8][256];
+
+    constexpr Crc32cTables() :
+      table{}
+    {
+      for (std::uint32_t i = 0u; i < 256u; ++i)
+      {
+        std::uint32_t crc = i;
+
+        for (int bit = 0; bit < 8; ++bit)
+        {
+          crc = crc & 1u ? (crc >> 1) ^ k_Crc32cPoly : crc >> 1;
+        }
+
+        table[0][i] = crc;
+      }
+
+      for (std::uint32_t i = 0u; i < 256u; ++i)
+      {
+        for (int slice = 1; slice < 8; ++slice)
+        {
+          table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFFu];
+        }
+      }
+    }
+  };
+
+  static constexpr Crc32cTables k_Crc32cTables = {};
+
+  static std::uint32_t LoadLE32(const unsigned char* const bytes) noexcept
+  {
+    return std::uint32_t(bytes[0]) | std::uint32_t(bytes[1]) << 8 | std::uint32_t(bytes[2]) << 16 | std::uint32_t(bytes[3]) << 24;
+  }
+
+  static std::uint32_t Crc32cUpdateSoftware(std::uint32_t crc, const unsigned char* data, std::size_t num_bytes)
+  {
+    const auto& table = k_Crc32cTables.table;
+
+    while (num_bytes >= 8u)
+    {
+      const std::uint32_t lo = crc ^ LoadLE32(data);
+      const std::uint32_t hi = LoadLE32(data + 4);
+
+      crc = table[7][lo & 0xFFu] ^ table[6][(lo >> 8) & 0xFFu] ^ table[5][(lo >> 16) & 0xFFu] ^ table[4][lo >> 24] ^
+            table[3][hi & 0xFFu] ^ table[2][(hi >> 8) & 0xFFu] ^ table[1][(hi >> 16) & 0xFFu] ^ table[0][hi >> 24];
+
+      data += 8;
+      num_bytes -= 8u;
+    }
+
+    while (num_bytes--)
+    {
+      crc = table[0][(crc ^ *data++) & 0xFFu] ^ (crc >> 8);
+    }
+
+    return crc;
+  }
+
+#if JOB_CRC32C_X86_GNU || JOB_CRC32C_X86_MSVC
+#if JOB_CRC32C_X86_GNU
+  __attribute__((target("sse4.2")))
+#endif
+  static std::uint32_t Crc32cUpdateHardware(std::uint32_t crc, const unsigned char* data, std::size_t num_bytes)
+  {
+    std::uint64_t crc64 = crc;
+
+    while (num_bytes >= 8u)
+    {
+      std::uint64_t word;
+      std::memcpy(&word, data, sizeof(word));
+
+      crc64 = _mm_crc32_u64(crc64, word);
+      data += 8;
+      num_bytes -= 8u;
+    }
+
+    crc = std::uint32_t(crc64);
+
+    while (num_bytes--)
+    {
+      crc = _mm_crc32_u8(crc, *data++);
+    }
+
+    return crc;
+  }
+
+  static bool CpuHasCrc32c() noexcept
+  {
+#if JOB_CRC32C_X86_GNU
+    return __builtin_cpu_supports("sse4.2");
+#else
+    int cpu_info[4];
+    __cpuid(cpu_info, 1);
+    return (cpu_info[2] & (1 << 20)) != 0;
+#endif
+  }
+#elif JOB_CRC32C_ARM
+  static std::uint32_t Crc32cUpdateHardware(std::uint32_t crc, const unsigned char* data, std::size_t num_bytes)
+  {
+    while (num_bytes >= 8u)
+    {
+      std::uint64_t word;
+      std::memcpy(&word, data, sizeof(word));
+
+      crc = __crc32cd(crc, word);
+      data += 8;
+      num_bytes -= 8u;
+    }
+
+    while (num_bytes--)
+    {
+      crc = __crc32cb(crc, *data++);
+    }
+
+    return crc;
+  }
+
+  static bool CpuHasCrc32c() noexcept
+  {
+    return true;
+  }
+#endif
+
+  static Crc32cUpdateFn SelectCrc32cUpdate() noexcept
+  {
+#if JOB_CRC32C_X86_GNU || JOB_CRC32C_X86_MSVC || JOB_CRC32C_ARM
+    if (CpuHasCrc32c())
+    {
+      return &Crc32cUpdateHardware;
+    }
+#endif
+
+    return &Crc32cUpdateSoftware;
+  }
+
+  // Product of two polynomials modulo `k_Crc32cPoly`, bit 31 is x^0.
+  static constexpr std::uint32_t Crc32cMultiplyModP(const std::uint32_t a, std::uint32_t b) noexcept
+  {
+    std::uint32_t mask    = std::uint32_t(1u) << 31;
+    std::uint32_t product = 0u;
+
+    while (mask)
+    {
+      if (a & mask)
+      {
+        product ^= b;
+      }
+
+      mask >>= 1;
+      b = b & 1u ? (b >> 1) ^ k_Crc32cPoly : b >> 1;
+    }
+
+    return product;
+  }
+
+  // `powers[k]` = x^(2^k) mod P, enough for the bit length of any 64 bit byte count.
+  struct Crc32cPowers
+  {
+    std::uint32_t powers[64 + 3];
+
+    constexpr Crc32cPowers() :
+      powers{}
+    {
+      std::uint32_t power = std::uint32_t(1u) << 30;  // x^1
+
+      for (std::uint32_t& value : powers)
+      {
+        value = power;
+        power = Crc32cMultiplyModP(power, power);
+      }
+    }
+  };
+
+  static constexpr Crc32cPowers k_Crc32cPowers = {};
+
+  struct Crc32cPart
+  {
+    std::uint32_t crc;
+    std::size_t   num_bytes;
+  };
+}  // namespace
+
+std::uint32_t Job::Crc32c(const void* const data, const std::size_t num_bytes, const std::uint32_t crc) noexcept
+{
+  static const Crc32cUpdateFn s_Update = SelectCrc32cUpdate();
+
+  return ~s_Update(~crc, static_cast<const unsigned char*>(data), num_bytes);
+}
+
+std::uint32_t Job::Crc32cCombine(const std::uint32_t crc_a, const std::uint32_t crc_b, const std::size_t num_bytes_b) noexcept
+{
+  // x^(8 * num_bytes_b) built from the binary expansion of the exponent, starting from x^8 = powers[3].
+  std::uint32_t shift = std::uint32_t(1u) << 31;  // x^0
+  std::size_t   bits  = num_bytes_b;
+
+  for (unsigned power_index = 3u; bits; bits >>= 1, ++power_index)
+  {
+    if (bits & 1u)
+    {
+      shift = Crc32cMultiplyModP(k_Crc32cPowers.powers[power_index], shift);
+    }
+  }
+
+  return Crc32cMultiplyModP(shift, crc_a) ^ crc_b;
+}
+
+std::uint32_t Job::ParallelCrc32c(const void* const data, const std::size_t num_bytes)
+{
+  const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+
+  return ParallelReduceDeterministic(
+          std::size_t(0u),
+          num_bytes,
+          k_BytesChunkSize,
+          Crc32cPart{0u, 0u},
+          [bytes](const std::size_t index_begin, const std::size_t index_end) {
+            return Crc32cPart{Crc32c(bytes + index_begin, index_end - index_begin), index_end - index_begin};
+          },
+          [](const Crc32cPart& lhs, const Crc32cPart& rhs) {
+            return Crc32cPart{Crc32cCombine(lhs.crc, rhs.crc, rhs.num_bytes), lhs.num_bytes + rhs.num_bytes};
+          })
+   .crc;
+}
+
+Task* Job::ParallelCopy(void* const dst, const void* const src, const std::size_t num_bytes, Task* const parent)
+{
+  unsigned char* const       dst_bytes  = static_cast<unsigned char*>(dst);
+  const unsigned char* const src_bytes  = static_cast<const unsigned char*>(src);
+  const std::uintptr_t       address    = reinterpret_cast<std::uintptr_t>(dst);
+  const std::size_t          num_chunks = detail::bytesChunkCount(address, num_bytes);
+  const bool                 streaming  = num_bytes >= k_BytesStreamingThreshold;
+
+  return ParallelFor(
+   std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [dst_bytes, src_bytes, address, num_bytes, streaming](Task* const, const std::size_t chunk_index) {
+     const detail::ByteChunk chunk      = detail::bytesChunkRange(address, num_bytes, chunk_index);
+     const std::size_t       chunk_size = chunk.end - chunk.begin;
+
+     if (streaming)
+     {
+       StreamCopy(dst_bytes + chunk.begin, src_bytes + chunk.begin, chunk_size);
+     }
+     else
+     {
+       std::memcpy(dst_bytes + chunk.begin, src_bytes + chunk.begin, chunk_size);
+     }
+   },
+   parent);
+}
+
+Task* Job::ParallelFill(void* const dst, const unsigned char value, const std::size_t num_bytes, Task* const parent)
+{
+  unsigned char* const dst_bytes  = static_cast<unsigned char*>(dst);
+  const std::uintptr_t address    = reinterpret_cast<std::uintptr_t>(dst);
+  const std::size_t    num_chunks = detail::bytesChunkCount(address, num_bytes);
+  const bool           streaming  = num_bytes >= k_BytesStreamingThreshold;
+
+  return ParallelFor(
+   std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [dst_bytes, value, address, num_bytes, streaming](Task* const, const std::size_t chunk_index) {
+     const detail::ByteChunk chunk      = detail::bytesChunkRange(address, num_bytes, chunk_index);
+     const std::size_t       chunk_size = chunk.end - chunk.begin;
+
+     if (streaming)
+     {
+       StreamFill(dst_bytes + chunk.begin, value, chunk_size);
+     }
+     else
+     {
+       std::memset(dst_bytes + chunk.begin, value, chunk_size);
+     }
+   },
+   parent);
+}
+
+#undef JOB_BYTES_SSE2
+#undef JOB_CRC32C_X86_GNU
+#undef JOB_CRC32C_X86_MSVC
+#undef JOB_CRC32C_ARM
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,238 @@
+/******************************************************************************/
+/*!
+ * @file   job_data_flow.cpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Data-flow tasks, dependencies are inferred from the declared read and
+ *   write sets of each task instead of being wired up by hand.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#include "concurrent/job_data_flow.hpp"
+
+#include <algorithm> /* find */
+
+namespace
+{
+  using namespace Job;
+
+  // Only its address is used, marks the successor list of a finished node.
+  static detail::DataFlowEdge s_ClosedSuccessorList = {nullptr, nullptr};
+
+  static detail::DataFlowEdge* ClosedSuccessorList() noexcept
+  {
+    return &s_ClosedSuccessorList;
+  }
+
+  static bool AccessContains(const DataFlowAccess& access, const void* const resource) noexcept
+  {
+    return std::find(access.resources, access.resources + access.count, resource) != access.resources + access.count;
+  }
+}  // namespace
+
+Job::DataFlow::DataFlow() :
+  m_Nodes{},
+  m_Edges{},
+  m_Resources{},
+  m_NumUnfinished{1u},
+  m_DoneTask{nullptr}
+{
+}
+
+Job::DataFlow::~DataFlow()
+{
+  Wait();
+}
+
+void Job::DataFlow::Wait()
+{
+  const std::size_t num_nodes = m_Nodes.Size();
+
+  if (num_nodes != 0u)
+  {
+    // NOTE(SR):
+    //   `m_DoneTask` is submitted by whoever finishes the last node, waiting
+    //   on its continuation instead means there is always a task already
+    //   bound to a queue to wait on.
+    Task* const done_task = TaskMake([](Task* const) {});
+
+    m_DoneTask = TaskMake([](Task* const) {});
+    TaskAddContinuation(m_DoneTask, done_task);
+
+    // `done_task` may finish and be garbage collected before we wait on it.
+    TaskIncRef(done_task);
+
+    if (m_NumUnfinished.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+    {
+      TaskSubmit(m_DoneTask);
+    }
+
+    WaitOnTask(done_task);
+    TaskDecRef(done_task);
+
+    m_DoneTask = nullptr;
+    m_NumUnfinished.store(1u, std::memory_order_relaxed);
+  }
+
+  m_Nodes.Reset();
+  m_Edges.Reset();
+
+  // NOTE(SR):
+  //   Entries are reset rather than erased so frames naming the same
+  //   resources do not reallocate the map, it is only dropped once it is
+  //   mostly made up of resources the last frame did not touch.
+  if (m_Resources.size() > (num_nodes + 1u) * k_DataFlowMaxAccesses)
+  {
+    m_Resources.clear();
+  }
+  else
+  {
+    for (auto& resource : m_Resources)
+    {
+      resource.second = ResourceState{nullptr, nullptr};
+    }
+  }
+}
+
+void Job::DataFlow::submitNode(detail::DataFlowNode* const node, const DataFlowReads& reads, const DataFlowWrites& writes)
+{
+  node->owner            = this;
+  node->last_predecessor = nullptr;
+  node->successors.store(nullptr, std::memory_order_relaxed);
+  node->num_pending.store(1, std::memory_order_relaxed);
+
+  m_NumUnfinished.fetch_add(1u, std::memory_order_relaxed);
+
+  for (std::size_t i = 0u; i < reads.count; ++i)
+  {
+    const void* const resource = reads.resources[i];
+
+    if (AccessContains(writes, resource))
+    {
+      continue;
+    }
+
+    ResourceState& state = m_Resources[resource];
+
+    if (state.last_writer)
+    {
+      addEdge(state.last_writer, node);
+    }
+
+    detail::DataFlowEdge* const reader = m_Edges.Allocate();
+    reader->node                       = node;
+    reader->next                       = state.readers;
+    state.readers                      = reader;
+  }
+
+  for (std::size_t i = 0u; i < writes.count; ++i)
+  {
+    ResourceState& state = m_Resources[writes.resources[i]];
+
+    if (state.readers)
+    {
+      for (const detail::DataFlowEdge* reader = state.readers; reader; reader = reader->next)
+      {
+        addEdge(reader->node, node);
+      }
+    }
+    else if (state.last_writer)
+    {
+      addEdge(state.last_writer, node);
+    }
+
+    state.last_writer = node;
+    state.readers     = nullptr;
+  }
+
+  // Drop the submission guard, any predecessors that already finished did not count.
+  if (node->num_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    scheduleNode(node);
+  }
+}
+
+void Job::DataFlow::addEdge(detail::DataFlowNode* const predecessor, detail::DataFlowNode* const successor)
+{
+  if (predecessor == successor || predecessor == successor->last_predecessor)
+  {
+    return;
+  }
+
+  successor->last_predecessor = predecessor;
+
+  detail::DataFlowEdge* const edge = m_Edges.Allocate();
+  edge->node                       = successor;
+  edge->next                       = predecessor->successors.load(std::memory_order_acquire);
+
+  // Counted before publishing the edge so a finishing predecessor can never drop it to zero early.
+  successor->num_pending.fetch_add(1, std::memory_order_relaxed);
+
+  while (edge->next != ClosedSuccessorList())
+  {
+    if (predecessor->successors.compare_exchange_weak(edge->next, edge, std::memory_order_release, std::memory_order_acquire))
+    {
+      return;
+    }
+  }
+
+  // The predecessor already finished.
+  successor->num_pending.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Job::DataFlow::scheduleNode(detail::DataFlowNode* const node)
+{
+  TaskSubmit(TaskMake([node](Task* const task) { runNode(node, task); }));
+}
+
+void Job::DataFlow::runNode(detail::DataFlowNode* const node, Task* const task)
+{
+  node->invoke(node, task);
+
+  DataFlow* const       owner      = node->owner;
+  detail::DataFlowEdge* successors = node->successors.exchange(ClosedSuccessorList(), std::memory_order_acq_rel);
+
+  while (successors)
+  {
+    detail::DataFlowNode* const successor = successors->node;
+
+    successors = successors->next;
+
+    if (successor->num_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      scheduleNode(successor);
+    }
+  }
+
+  if (owner->m_NumUnfinished.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+  {
+    TaskSubmit(owner->m_DoneTask);
+  }
+}
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,253 @@
+/******************************************************************************/
+/*!
+ * @file   job_file.cpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Platform specific file mapping used by the parallel file algorithms.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#include "concurrent/job_file.hpp"
+
+#if _WIN32
+#define IS_WINDOWS 1
+#define IS_POSIX   0
+#elif (__APPLE__ || __ANDROID__ || __linux || __unix || __posix)
+#define IS_WINDOWS 0
+#define IS_POSIX   1
+#else
+#define IS_WINDOWS 0
+#define IS_POSIX   0
+#endif
+
+#if IS_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define VC_EXTRALEAN
+#define WINDOWS_EXTRA_LEAN
+
+#include <Windows.h> /* CreateFileA, CreateFileMappingA, MapViewOfFile */
+#elif IS_POSIX
+#include <fcntl.h>    /* open           */
+#include <sys/mman.h> /* mmap, madvise  */
+#include <sys/stat.h> /* fstat          */
+#include <unistd.h>   /* close, sysconf */
+#endif
+
+namespace
+{
+#if IS_POSIX
+  // madvise needs a page aligned start, widens [offset, offset + size) to whole pages clamped to the mapping.
+  static void Advise(const char* const data, const std::size_t mapping_size, std::size_t offset, std::size_t size, const int advice) noexcept
+  {
+    if (!data || offset >= mapping_size)
+    {
+      return;
+    }
+
+    static const std::size_t k_PageSize = std::size_t(sysconf(_SC_PAGESIZE));
+
+    size = size < mapping_size - offset ? size : mapping_size - offset;
+
+    const std::size_t page_offset = offset % k_PageSize;
+
+    offset -= page_offset;
+    size += page_offset;
+
+    madvise(const_cast<char*>(data) + offset, size, advice);
+  }
+#endif
+}  // namespace
+
+Job::MappedFile::MappedFile() noexcept :
+  m_Data{nullptr},
+  m_Size{0u},
+  m_FileHandle{nullptr},
+  m_MappingHandle{nullptr}
+{
+}
+
+Job::MappedFile::~MappedFile() noexcept
+{
+  Close();
+}
+
+bool Job::MappedFile::Open(const char* const path) noexcept
+{
+  Close();
+
+#if IS_WINDOWS
+  const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+
+  if (!GetFileSizeEx(file, &file_size))
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  m_FileHandle = file;
+  m_Size       = std::size_t(file_size.QuadPart);
+
+  // Zero sized files cannot be mapped, they are represented as an open file with no data.
+  if (m_Size == 0u)
+  {
+    return true;
+  }
+
+  const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (!mapping)
+  {
+    Close();
+    return false;
+  }
+
+  m_MappingHandle = mapping;
+  m_Data          = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+  if (!m_Data)
+  {
+    Close();
+    return false;
+  }
+
+  return true;
+#elif IS_POSIX
+  const int fd = open(path, O_RDONLY);
+
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat file_stat;
+
+  if (fstat(fd, &file_stat) != 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  m_Size = std::size_t(file_stat.st_size);
+
+  // Zero sized files cannot be mapped, they are represented as an open file with no data.
+  if (m_Size != 0u)
+  {
+    void* const mapping = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+      m_Size = 0u;
+      close(fd);
+      return false;
+    }
+
+    m_Data = static_cast<const char*>(mapping);
+    madvise(mapping, m_Size, MADV_SEQUENTIAL);
+  }
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  return true;
+#else
+  (void)path;
+  return false;
+#endif
+}
+
+void Job::MappedFile::Close() noexcept
+{
+#if IS_WINDOWS
+  if (m_Data)
+  {
+    UnmapViewOfFile(m_Data);
+  }
+
+  if (m_MappingHandle)
+  {
+    CloseHandle(m_MappingHandle);
+  }
+
+  if (m_FileHandle)
+  {
+    CloseHandle(m_FileHandle);
+  }
+#elif IS_POSIX
+  if (m_Data)
+  {
+    munmap(const_cast<char*>(m_Data), m_Size);
+  }
+#endif
+
+  m_Data          = nullptr;
+  m_Size          = 0u;
+  m_FileHandle    = nullptr;
+  m_MappingHandle = nullptr;
+}
+
+void Job::MappedFile::AdviseSequential(const std::size_t offset, const std::size_t size) const noexcept
+{
+#if IS_POSIX
+  Advise(m_Data, m_Size, offset, size, MADV_SEQUENTIAL);
+#else
+  (void)offset;
+  (void)size;
+#endif
+}
+
+void Job::MappedFile::AdviseWillNeed(const std::size_t offset, const std::size_t size) const noexcept
+{
+#if IS_POSIX
+  Advise(m_Data, m_Size, offset, size, MADV_WILLNEED);
+#elif IS_WINDOWS
+  if (m_Data && offset < m_Size)
+  {
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<char*>(m_Data) + offset;
+    range.NumberOfBytes  = size < m_Size - offset ? size : m_Size - offset;
+
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+#else
+  (void)offset;
+  (void)size;
+#endif
+}
+
+#undef IS_WINDOWS
+#undef IS_POSIX
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,256 @@
+/******************************************************************************/
+/*!
+ * @file   job_graph.cpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Parallel graph traversal over graphs stored in compressed sparse row form.
+ *
+ *   References:
+ *     [Direction-Optimizing Breadth-First Search (Beamer, Asanovic, Patterson)]
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#include "concurrent/job_graph.hpp"
+
+#include "concurrent/job_api.hpp"           // ParallelFor, TaskSubmitAndWait
+#include "concurrent/job_assert.hpp"        // JobAssert
+#include "concurrent/job_worker_local.hpp"  // WorkerLocal
+
+#include <algorithm> /* fill, min      */
+#include <atomic>    /* atomic<T>      */
+#include <memory>    /* unique_ptr     */
+#include <vector>    /* vector         */
+
+namespace
+{
+  using namespace Job;
+
+  using AtomicWord = std::atomic<std::uint64_t>;
+
+  static constexpr std::uint32_t k_BitsPerWord = 64u;
+
+  // Runs `fn(index_begin, index_end)` over [0, count) in blocks of `block_size` and waits for it to finish.
+  template<typename F>
+  static void ParallelForBlocks(const std::size_t count, const std::size_t block_size, const F& fn)
+  {
+    const std::size_t num_blocks = (count + block_size - 1u) / block_size;
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_blocks, Splitter::MaxItemsPerTask(1u), [&fn, count, block_size](Task* const, const std::size_t block) {
+       const std::size_t index_begin = block * block_size;
+       const std::size_t index_end   = std::min(index_begin + block_size, count);
+
+       fn(index_begin, index_end);
+     }));
+  }
+
+  class AtomicBitmap
+  {
+   private:
+    std::unique_ptr<AtomicWord[]> m_Words;
+    std::size_t                   m_NumWords;
+
+   public:
+    explicit AtomicBitmap(const std::uint32_t num_bits) :
+      m_Words{new AtomicWord[(num_bits + k_BitsPerWord - 1u) / k_BitsPerWord]()},
+      m_NumWords{(num_bits + k_BitsPerWord - 1u) / k_BitsPerWord}
+    {
+    }
+
+    bool Test(const std::uint32_t index) const noexcept
+    {
+      return (m_Words[index / k_BitsPerWord].load(std::memory_order_relaxed) & Bit(index)) != 0u;
+    }
+
+    void Set(const std::uint32_t index) noexcept
+    {
+      m_Words[index / k_BitsPerWord].fetch_or(Bit(index), std::memory_order_relaxed);
+    }
+
+    // Returns true only for the one caller that changed the bit from 0 to 1.
+    bool TrySet(const std::uint32_t index) noexcept
+    {
+      AtomicWord&         word = m_Words[index / k_BitsPerWord];
+      const std::uint64_t bit  = Bit(index);
+
+      // Plain load first since most of the time the vertex has already been claimed.
+      if ((word.load(std::memory_order_relaxed) & bit) != 0u)
+      {
+        return false;
+      }
+
+      return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0u;
+    }
+
+    void Clear(const std::size_t words_per_task)
+    {
+      AtomicWord* const words = m_Words.get();
+
+      ParallelForBlocks(m_NumWords, words_per_task, [words](const std::size_t index_begin, const std::size_t index_end) {
+        for (std::size_t i = index_begin; i < index_end; ++i)
+        {
+          words[i].store(0u, std::memory_order_relaxed);
+        }
+      });
+    }
+
+   private:
+    static std::uint64_t Bit(const std::uint32_t index) noexcept
+    {
+      return std::uint64_t(1u) << (index % k_BitsPerWord);
+    }
+  };
+
+  struct BFSWorkerState
+  {
+    std::vector<std::uint32_t> next_frontier       = {};
+    std::uint64_t              next_frontier_edges = 0u;
+  };
+}  // namespace
+
+std::size_t Job::ParallelBFS(const CSRGraph& graph, const std::uint32_t source, std::int32_t* const out_levels, const BFSOptions& options)
+{
+  JobAssert(source < graph.num_vertices, "The source vertex must be in the graph.");
+
+  const std::uint32_t num_vertices = graph.num_vertices;
+  const CSRGraph&     in_graph     = options.transposed ? *options.transposed : graph;
+  const std::size_t   block_size   = options.vertices_per_task ? options.vertices_per_task : 1u;
+
+  ParallelForBlocks(num_vertices, block_size, [out_levels](const std::size_t index_begin, const std::size_t index_end) {
+    std::fill(out_levels + index_begin, out_levels + index_end, std::int32_t(-1));
+  });
+
+  AtomicBitmap                visited{num_vertices};
+  AtomicBitmap                frontier_bits{num_vertices};
+  WorkerLocal<BFSWorkerState> worker_states{};
+  std::vector<std::uint32_t>  frontier         = {source};
+  std::uint64_t               frontier_edges   = graph.Degree(source);
+  std::uint64_t               unexplored_edges = graph.NumEdges() - frontier_edges;
+  std::size_t                 num_reached      = 1u;
+  std::int32_t                level            = 0;
+  bool                        is_bottom_up     = false;
+
+  visited.Set(source);
+  out_levels[source] = 0;
+
+  while (!frontier.empty())
+  {
+    if (options.allow_bottom_up)
+    {
+      is_bottom_up = is_bottom_up ? frontier.size() >= num_vertices / options.beta :
+                                    frontier_edges > unexplored_edges / options.alpha;
+    }
+
+    const std::int32_t next_level = level + 1;
+
+    if (is_bottom_up)
+    {
+      // Every unvisited vertex looks for a parent in the current frontier.
+
+      frontier_bits.Clear(block_size);
+
+      ParallelForBlocks(frontier.size(), block_size, [&frontier, &frontier_bits](const std::size_t index_begin, const std::size_t index_end) {
+        for (std::size_t i = index_begin; i < index_end; ++i)
+        {
+          frontier_bits.Set(frontier[i]);
+        }
+      });
+
+      ParallelForBlocks(num_vertices, block_size, [&](const std::size_t index_begin, const std::size_t index_end) {
+        BFSWorkerState& state = worker_states.Local();
+
+        for (std::uint32_t vertex = std::uint32_t(index_begin); vertex < index_end; ++vertex)
+        {
+          if (visited.Test(vertex))
+          {
+            continue;
+          }
+
+          const std::uint64_t edge_end = in_graph.row_offsets[vertex + 1u];
+
+          for (std::uint64_t edge = in_graph.row_offsets[vertex]; edge < edge_end; ++edge)
+          {
+            if (frontier_bits.Test(in_graph.columns[edge]))
+            {
+              visited.Set(vertex);
+              out_levels[vertex] = next_level;
+              state.next_frontier.push_back(vertex);
+              state.next_frontier_edges += graph.Degree(vertex);
+              break;
+            }
+          }
+        }
+      });
+    }
+    else
+    {
+      // Every frontier vertex tries to claim its unvisited neighbors.
+
+      ParallelForBlocks(frontier.size(), block_size, [&](const std::size_t index_begin, const std::size_t index_end) {
+        BFSWorkerState& state = worker_states.Local();
+
+        for (std::size_t i = index_begin; i < index_end; ++i)
+        {
+          const std::uint32_t vertex   = frontier[i];
+          const std::uint64_t edge_end = graph.row_offsets[vertex + 1u];
+
+          for (std::uint64_t edge = graph.row_offsets[vertex]; edge < edge_end; ++edge)
+          {
+            const std::uint32_t neighbor = graph.columns[edge];
+
+            if (visited.TrySet(neighbor))
+            {
+              out_levels[neighbor] = next_level;
+              state.next_frontier.push_back(neighbor);
+              state.next_frontier_edges += graph.Degree(neighbor);
+            }
+          }
+        }
+      });
+    }
+
+    frontier.clear();
+    frontier_edges = 0u;
+
+    worker_states.ForEach([&frontier, &frontier_edges](BFSWorkerState& state) {
+      frontier.insert(frontier.end(), state.next_frontier.begin(), state.next_frontier.end());
+      frontier_edges += state.next_frontier_edges;
+
+      state.next_frontier.clear();
+      state.next_frontier_edges = 0u;
+    });
+
+    unexplored_edges -= std::min(frontier_edges, unexplored_edges);
+    num_reached += frontier.size();
+    level = next_level;
+  }
+
+  return num_reached;
+}
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -0,0 +1,508 @@
+/******************************************************************************/
+/*!
+ * @file   job_numeric.cpp
+ * @author Shareef Abdoul-Raheem (https://blufedora.github.io/)
+ * @brief
+ *   Vectorized leaf kernels and the chunked drivers for the numeric reductions.
+ *
+ * @copyright Copyright (c) 2024 Shareef Abdoul-Raheem
+ */
+/******************************************************************************/
+#include "concurrent/job_numeric.hpp"
+
+#include "concurrent/job_api.hpp"  // ParallelFor, TaskSubmitAndWait
+
+#include <algorithm>  // min
+#include <limits>     // numeric_limits
+#include <memory>     // unique_ptr
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JOB_NUMERIC_SSE2 1
+#include <emmintrin.h>  // _mm_loadu_ps, _mm_add_ps, _mm_min_ps, _mm_max_ps, _mm_cmpeq_ps
+#else
+#define JOB_NUMERIC_SSE2 0
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define JOB_NUMERIC_AVX2_GNU    1
+#define JOB_NUMERIC_AVX2_MSVC   0
+#define JOB_NUMERIC_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>  // _mm256_loadu_ps, _mm256_add_ps, _mm256_min_ps, _mm256_max_ps, _mm256_cmp_ps
+#elif defined(_M_X64) && defined(_MSC_VER)
+#define JOB_NUMERIC_AVX2_GNU    0
+#define JOB_NUMERIC_AVX2_MSVC   1
+#define JOB_NUMERIC_TARGET_AVX2
+#include <immintrin.h>  // _mm256_loadu_ps, _mm256_add_ps, _mm256_min_ps, _mm256_max_ps, _mm256_cmp_ps, _xgetbv
+#include <intrin.h>     // __cpuid, __cpuidex
+#else
+#define JOB_NUMERIC_AVX2_GNU    0
+#define JOB_NUMERIC_AVX2_MSVC   0
+#define JOB_NUMERIC_TARGET_AVX2
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define JOB_NUMERIC_NEON 1
+#include <arm_neon.h>  // vld1q_f32, vaddq_f32, vminq_f32, vmaxq_f32, vceqq_f32
+#else
+#define JOB_NUMERIC_NEON 0
+#endif
+
+namespace
+{
+  using namespace Job;
+
+  using SumFn       = double (*)(const float* data, std::size_t count);
+  using MinMaxFn    = MinMaxResult (*)(const float* data, std::size_t count);
+  using FindEqualFn = std::size_t (*)(const float* data, std::size_t count, float value);  // Returns `count` if not found.
+
+  struct NumericKernels
+  {
+    SimdLevel   level;
+    SumFn       sum;
+    MinMaxFn    min_max;
+    FindEqualFn find_equal;
+  };
+
+  static constexpr float k_PositiveInfinity = std::numeric_limits<float>::infinity();
+  static constexpr float k_NegativeInfinity = -std::numeric_limits<float>::infinity();
+
+  static double SumScalar(const float* const data, const std::size_t count)
+  {
+    float       lanes[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    std::size_t i        = 0u;
+
+    for (; i + 4u <= count; i += 4u)
+    {
+      lanes[0] += data[i + 0u];
+      lanes[1] += data[i + 1u];
+      lanes[2] += data[i + 2u];
+      lanes[3] += data[i + 3u];
+    }
+
+    double sum = double(lanes[0]) + double(lanes[1]) + double(lanes[2]) + double(lanes[3]);
+
+    for (; i < count; ++i)
+    {
+      sum += data[i];
+    }
+
+    return sum;
+  }
+
+  static MinMaxResult MinMaxScalar(const float* const data, const std::size_t count)
+  {
+    MinMaxResult result = {k_PositiveInfinity, k_NegativeInfinity};
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+      result.min = data[i] < result.min ? data[i] : result.min;
+      result.max = data[i] > result.max ? data[i] : result.max;
+    }
+
+    return result;
+  }
+
+  static std::size_t FindEqualScalar(const float* const data, const std::size_t count, const float value)
+  {
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+      if (data[i] == value)
+      {
+        return i;
+      }
+    }
+
+    return count;
+  }
+
+  // Folds the stored lanes of the min and max vectors into the scalar result of the leftover `tail` elements.
+  template<std::size_t k_NumLanes>
+  static MinMaxResult FoldMinMaxLanes(const float (&min_lanes)[k_NumLanes], const float (&max_lanes)[k_NumLanes], const float* const tail, const std::size_t tail_count)
+  {
+    MinMaxResult result = MinMaxScalar(tail, tail_count);
+
+    for (std::size_t lane = 0u; lane < k_NumLanes; ++lane)
+    {
+      result.min = min_lanes[lane] < result.min ? min_lanes[lane] : result.min;
+      result.max = max_lanes[lane] > result.max ? max_lanes[lane] : result.max;
+    }
+
+    return result;
+  }
+
+#if JOB_NUMERIC_SSE2
+  static double SumSse2(const float* const data, const std::size_t count)
+  {
+    __m128      acc0 = _mm_setzero_ps();
+    __m128      acc1 = _mm_setzero_ps();
+    __m128      acc2 = _mm_setzero_ps();
+    __m128      acc3 = _mm_setzero_ps();
+    std::size_t i    = 0u;
+
+    // Four independent accumulators hide the latency of the adds.
+    for (; i + 16u <= count; i += 16u)
+    {
+      acc0 = _mm_add_ps(acc0, _mm_loadu_ps(data + i + 0u));
+      acc1 = _mm_add_ps(acc1, _mm_loadu_ps(data + i + 4u));
+      acc2 = _mm_add_ps(acc2, _mm_loadu_ps(data + i + 8u));
+      acc3 = _mm_add_ps(acc3, _mm_loadu_ps(data + i + 12u));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+
+    return double(lanes[0]) + double(lanes[1]) + double(lanes[2]) + double(lanes[3]) + SumScalar(data + i, count - i);
+  }
+
+  static MinMaxResult MinMaxSse2(const float* const data, const std::size_t count)
+  {
+    __m128      min0 = _mm_set1_ps(k_PositiveInfinity);
+    __m128      min1 = min0;
+    __m128      max0 = _mm_set1_ps(k_NegativeInfinity);
+    __m128      max1 = max0;
+    std::size_t i    = 0u;
+
+    for (; i + 8u <= count; i += 8u)
+    {
+      const __m128 values0 = _mm_loadu_ps(data + i + 0u);
+      const __m128 values1 = _mm_loadu_ps(data + i + 4u);
+
+      min0 = _mm_min_ps(min0, values0);
+      min1 = _mm_min_ps(min1, values1);
+      max0 = _mm_max_ps(max0, values0);
+      max1 = _mm_max_ps(max1, values1);
+    }
+
+    float min_lanes[4];
+    float max_lanes[4];
+    _mm_storeu_ps(min_lanes, _mm_min_ps(min0, min1));
+    _mm_storeu_ps(max_lanes, _mm_max_ps(max0, max1));
+
+    return FoldMinMaxLanes(min_lanes, max_lanes, data + i, count - i);
+  }
+
+  static std::size_t FindEqualSse2(const float* const data, const std::size_t count, const float value)
+  {
+    const __m128 needle = _mm_set1_ps(value);
+    std::size_t  i      = 0u;
+
+    for (; i + 4u <= count; i += 4u)
+    {
+      if (_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), needle)))
+      {
+        return i + FindEqualScalar(data + i, 4u, value);
+      }
+    }
+
+    return i + FindEqualScalar(data + i, count - i, value);
+  }
+#endif
+
+#if JOB_NUMERIC_AVX2_GNU || JOB_NUMERIC_AVX2_MSVC
+  JOB_NUMERIC_TARGET_AVX2
+  static double SumAvx2(const float* const data, const std::size_t count)
+  {
+    __m256      acc0 = _mm256_setzero_ps();
+    __m256      acc1 = _mm256_setzero_ps();
+    __m256      acc2 = _mm256_setzero_ps();
+    __m256      acc3 = _mm256_setzero_ps();
+    std::size_t i    = 0u;
+
+    for (; i + 32u <= count; i += 32u)
+    {
+      acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(data + i + 0u));
+      acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(data + i + 8u));
+      acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(data + i + 16u));
+      acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(data + i + 24u));
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+
+    double sum = SumScalar(data + i, count - i);
+
+    for (const float lane : lanes)
+    {
+      sum += lane;
+    }
+
+    return sum;
+  }
+
+  JOB_NUMERIC_TARGET_AVX2
+  static MinMaxResult MinMaxAvx2(const float* const data, const std::size_t count)
+  {
+    __m256      min0 = _mm256_set1_ps(k_PositiveInfinity);
+    __m256      min1 = min0;
+    __m256      max0 = _mm256_set1_ps(k_NegativeInfinity);
+    __m256      max1 = max0;
+    std::size_t i    = 0u;
+
+    for (; i + 16u <= count; i += 16u)
+    {
+      const __m256 values0 = _mm256_loadu_ps(data + i + 0u);
+      const __m256 values1 = _mm256_loadu_ps(data + i + 8u);
+
+      min0 = _mm256_min_ps(min0, values0);
+      min1 = _mm256_min_ps(min1, values1);
+      max0 = _mm256_max_ps(max0, values0);
+      max1 = _mm256_max_ps(max1, values1);
+    }
+
+    float min_lanes[8];
+    float max_lanes[8];
+    _mm256_storeu_ps(min_lanes, _mm256_min_ps(min0, min1));
+    _mm256_storeu_ps(max_lanes, _mm256_max_ps(max0, max1));
+
+    return FoldMinMaxLanes(min_lanes, max_lanes, data + i, count - i);
+  }
+
+  JOB_NUMERIC_TARGET_AVX2
+  static std::size_t FindEqualAvx2(const float* const data, const std::size_t count, const float value)
+  {
+    const __m256 needle = _mm256_set1_ps(value);
+    std::size_t  i      = 0u;
+
+    for (; i + 8u <= count; i += 8u)
+    {
+      if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data + i), needle, _CMP_EQ_OQ)))
+      {
+        return i + FindEqualScalar(data + i, 8u, value);
+      }
+    }
+
+    return i + FindEqualScalar(data + i, count - i, value);
+  }
+
+  static bool CpuHasAvx2() noexcept
+  {
+#if JOB_NUMERIC_AVX2_GNU
+    return __builtin_cpu_supports("avx2");
+#else
+    int cpu_info[4];
+    __cpuid(cpu_info, 1);
+
+    const bool os_saves_ymm = (cpu_info[2] & (1 << 27)) && (cpu_info[2] & (1 << 28)) && (_xgetbv(0) & 0x6u) == 0x6u;
+
+    __cpuidex(cpu_info, 7, 0);
+
+    return os_saves_ymm && (cpu_info[1] & (1 << 5)) != 0;
+#endif
+  }
+#endif
+
+#if JOB_NUMERIC_NEON
+  static double SumNeon(const float* const data, const std::size_t count)
+  {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = acc0;
+    float32x4_t acc2 = acc0;
+    float32x4_t acc3 = acc0;
+    std::size_t i    = 0u;
+
+    for (; i + 16u <= count; i += 16u)
+    {
+      acc0 = vaddq_f32(acc0, vld1q_f32(data + i + 0u));
+      acc1 = vaddq_f32(acc1, vld1q_f32(data + i + 4u));
+      acc2 = vaddq_f32(acc2, vld1q_f32(data + i + 8u));
+      acc3 = vaddq_f32(acc3, vld1q_f32(data + i + 12u));
+    }
+
+    return double(vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)))) + SumScalar(data + i, count - i);
+  }
+
+  static MinMaxResult MinMaxNeon(const float* const data, const std::size_t count)
+  {
+    float32x4_t min0 = vdupq_n_f32(k_PositiveInfinity);
+    float32x4_t min1 = min0;
+    float32x4_t max0 = vdupq_n_f32(k_NegativeInfinity);
+    float32x4_t max1 = max0;
+    std::size_t i    = 0u;
+
+    for (; i + 8u <= count; i += 8u)
+    {
+      const float32x4_t values0 = vld1q_f32(data + i + 0u);
+      const float32x4_t values1 = vld1q_f32(data + i + 4u);
+
+      min0 = vminq_f32(min0, values0);
+      min1 = vminq_f32(min1, values1);
+      max0 = vmaxq_f32(max0, values0);
+      max1 = vmaxq_f32(max1, values1);
+    }
+
+    MinMaxResult result = MinMaxScalar(data + i, count - i);
+    const float  min    = vminvq_f32(vminq_f32(min0, min1));
+    const float  max    = vmaxvq_f32(vmaxq_f32(max0, max1));
+
+    result.min = min < result.min ? min : result.min;
+    result.max = max > result.max ? max : result.max;
+
+    return result;
+  }
+
+  static std::size_t FindEqualNeon(const float* const data, const std::size_t count, const float value)
+  {
+    const float32x4_t needle = vdupq_n_f32(value);
+    std::size_t       i      = 0u;
+
+    for (; i + 4u <= count; i += 4u)
+    {
+      if (vmaxvq_u32(vceqq_f32(vld1q_f32(data + i), needle)))
+      {
+        return i + FindEqualScalar(data + i, 4u, value);
+      }
+    }
+
+    return i + FindEqualScalar(data + i, count - i, value);
+  }
+#endif
+
+  static NumericKernels SelectNumericKernels() noexcept
+  {
+#if JOB_NUMERIC_AVX2_GNU || JOB_NUMERIC_AVX2_MSVC
+    if (CpuHasAvx2())
+    {
+      return NumericKernels{SimdLevel::AVX2, &SumAvx2, &MinMaxAvx2, &FindEqualAvx2};
+    }
+#endif
+
+#if JOB_NUMERIC_SSE2
+    return NumericKernels{SimdLevel::SSE2, &SumSse2, &MinMaxSse2, &FindEqualSse2};
+#elif JOB_NUMERIC_NEON
+    return NumericKernels{SimdLevel::NEON, &SumNeon, &MinMaxNeon, &FindEqualNeon};
+#else
+    return NumericKernels{SimdLevel::SCALAR, &SumScalar, &MinMaxScalar, &FindEqualScalar};
+#endif
+  }
+
+  static const NumericKernels& Kernels() noexcept
+  {
+    static const NumericKernels s_Kernels = SelectNumericKernels();
+
+    return s_Kernels;
+  }
+
+  // Writes `chunk_fn(chunk_data, chunk_count, chunk_begin)` to `partials[chunk]` for every chunk, each slot has exactly one writer.
+  template<typename Partial, typename ChunkFn>
+  static std::unique_ptr<Partial[]> ReduceChunks(const float* const data, const std::size_t count, const std::size_t num_chunks, const ChunkFn chunk_fn)
+  {
+    std::unique_ptr<Partial[]> partials{new Partial[num_chunks]};
+    Partial* const             partials_data = partials.get();
+
+    TaskSubmitAndWait(ParallelFor(
+     std::size_t(0u), num_chunks, Splitter::MaxItemsPerTask(1u), [data, count, partials_data, chunk_fn](Task* const, const std::size_t chunk) {
+       const std::size_t chunk_begin = chunk * k_NumericChunkSize;
+
+       partials_data[chunk] = chunk_fn(data + chunk_begin, std::min(count - chunk_begin, k_NumericChunkSize), chunk_begin);
+     }));
+
+    return partials;
+  }
+
+  static std::size_t NumericChunkCount(const std::size_t count) noexcept
+  {
+    return (count + k_NumericChunkSize - 1u) / k_NumericChunkSize;
+  }
+}  // namespace
+
+Job::SimdLevel Job::NumericSimdLevel() noexcept
+{
+  return Kernels().level;
+}
+
+double Job::ParallelSum(const float* const data, const std::size_t count)
+{
+  const std::size_t num_chunks = NumericChunkCount(count);
+  const auto        partials   = ReduceChunks<double>(data, count, num_chunks, [](const float* const chunk_data, const std::size_t chunk_count, const std::size_t) {
+    return Kernels().sum(chunk_data, chunk_count);
+  });
+
+  double sum = 0.0;
+
+  for (std::size_t chunk = 0u; chunk < num_chunks; ++chunk)
+  {
+    sum += partials[chunk];
+  }
+
+  return sum;
+}
+
+Job::MinMaxResult Job::ParallelMinMax(const float* const data, const std::size_t count)
+{
+  const std::size_t num_chunks = NumericChunkCount(count);
+  const auto        partials   = ReduceChunks<MinMaxResult>(data, count, num_chunks, [](const float* const chunk_data, const std::size_t chunk_count, const std::size_t) {
+    return Kernels().min_max(chunk_data, chunk_count);
+  });
+
+  MinMaxResult result = {k_PositiveInfinity, k_NegativeInfinity};
+
+  for (std::size_t chunk = 0u; chunk < num_chunks; ++chunk)
+  {
+    result.min = partials[chunk].min < result.min ? partials[chunk].min : result.min;
+    result.max = partials[chunk].max > result.max ? partials[chunk].max : result.max;
+  }
+
+  return result;
+}
+
+Job::ArgMinResult Job::ParallelArgMin(const float* const data, const std::size_t count)
+{
+  const std::size_t num_chunks = NumericChunkCount(count);
+  const auto        partials   = ReduceChunks<ArgMinResult>(data, count, num_chunks, [](const float* const chunk_data, const std::size_t chunk_count, const std::size_t chunk_begin) {
+    // The chunk is still in cache for the second pass that finds where the minimum is.
+    const float min = Kernels().min_max(chunk_data, chunk_count).min;
+
+    return ArgMinResult{min, chunk_begin + Kernels().find_equal(chunk_data, chunk_count, min)};
+  });
+
+  if (num_chunks == 0u)
+  {
+    return ArgMinResult{k_PositiveInfinity, count};
+  }
+
+  // Seeded from the first chunk so a range of all +infinity still reports index 0.
+  ArgMinResult result = partials[0];
+
+  // Chunks are visited in order and only a strictly smaller value replaces the result so ties keep the lowest index.
+  for (std::size_t chunk = 1u; chunk < num_chunks; ++chunk)
+  {
+    if (partials[chunk].value < result.value)
+    {
+      result = partials[chunk];
+    }
+  }
+
+  return result;
+}
+
+#undef JOB_NUMERIC_SSE2
+#undef JOB_NUMERIC_AVX2_GNU
+#undef JOB_NUMERIC_AVX2_MSVC
+#undef JOB_NUMERIC_TARGET_AVX2
+#undef JOB_NUMERIC_NEON
+
+/******************************************************************************/
+/*
+  MIT License
+
+  Copyright (c) 2024 Shareef Abdoul-Raheem
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+/******************************************************************************/
@@ -22,14 +22,19 @@
 #include "concurrent/job_assert.hpp"  //
 #include "concurrent/job_queue.hpp"
 
-#include "pcg_basic.h" /* pcg_state_setseq_64, pcg32_srandom_r, pcg32_boundedrand_r */
+#include "pcg_basic.h" /* pcg_state_setseq_64, pcg32_random_t, pcg32_srandom_r, pcg32_random_r, pcg32_boundedrand_r */
 
-#include <algorithm> /* partition, for_each, distance                                                   */
+#include <algorithm> /* partition, for_each, distance, push_heap, pop_heap                               */
+#include <chrono>    /* steady_clock                                                                    */
 #include <cstdio>    /* fprintf, stderr                                                                 */
 #include <cstdlib>   /* abort                                                                           */
+#include <cstring>   /* memcpy                                                                          */
 #include <limits>    /* numeric_limits                                                                  */
+#include <memory>    /* unique_ptr                                                                      */
+#include <mutex>     /* mutex, lock_guard                                                               */
 #include <new>       /* hardware_constructive_interference_size, hardware_destructive_interference_size */
 #include <thread>    /* thread                                                                          */
+#include <vector>    /* vector                                                                          */
 
 #if _WIN32
 #define IS_WINDOWS         1
@@ -64,6 +69,17 @@
 // #include <sys/sysctl.h>
 #endif
 
+#if __linux
+#include <linux/membarrier.h> /* MEMBARRIER_CMD_QUERY, MEMBARRIER_CMD_PRIVATE_EXPEDITED, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED */
+#include <sys/syscall.h>      /* SYS_membarrier                                                                              */
+#endif
+
+#if __linux && defined(SYS_membarrier)
+#define HAS_MEMBARRIER 1
+#else
+#define HAS_MEMBARRIER 0
+#endif
+
 namespace Job
 {
   // Constants
@@ -74,8 +90,13 @@ namespace Job
   static constexpr std::size_t k_CachelineSize = 64u;
 #endif
 
-  static constexpr std::size_t k_ExpectedTaskSize = std::max(std::size_t(128u), k_CachelineSize);
-  static constexpr QueueType   k_InvalidQueueType = QueueType(int(QueueType::WORKER) + 1);
+  static constexpr std::size_t   k_ExpectedTaskSize           = std::max(std::size_t(128u), k_CachelineSize);
+  static constexpr QueueType     k_InvalidQueueType           = QueueType(int(QueueType::WORKER) + 1);
+  static constexpr WorkerID      k_TaskGraphIDBase            = 0x8000u;  //!< `Task::owning_worker` of a recorded task is this plus its graph's slot.
+  static constexpr std::size_t   k_MaxTaskGraphs              = 64u;      //!< The maximum number of task graphs alive at once.
+  static constexpr std::uint32_t k_HeartbeatPollsPerClockRead = 32u;      //!< `detail::heartbeatPoll` is called per loop iteration so only reads the clock this often.
+  static constexpr WorkerID      k_NoStealRequest             = 0xFFFFu;  //!< `ThreadLocalState::steal_request` when no thief is waiting.
+  static constexpr std::uint32_t k_StealRequestMaxSpins       = 4096u;    //!< How long a thief waits on a busy victim before taking back its steal request.
 
   // Type Aliases
 
@@ -177,16 +198,64 @@ namespace Job
     TaskMemoryBlock* freelist;
   };
 
+  struct TaskGraphSubmit
+  {
+    TaskHandle task;
+    QueueType  queue;
+  };
+
+  struct TaskGraph
+  {
+    TaskPool                           pool;             //!< `memory` is `tasks`, lets `TaskPtr`s address recorded tasks.
+    std::unique_ptr<TaskMemoryBlock[]> tasks;            //!< The recorded tasks followed by the dispatchers.
+    std::unique_ptr<TaskMemoryBlock[]> initial_tasks;    //!< Snapshot taken by `EndRecord`, copied over `tasks` by each replay.
+    TaskHandleType                     num_tasks;        //!< The number of recorded tasks.
+    TaskHandleType                     max_tasks;        //!< The number of tasks that may be recorded.
+    TaskHandleType                     num_dispatchers;  //!< Tasks that each run the highest priority ready task, one per recorded task.
+    WorkerID                           id;               //!< `k_TaskGraphIDBase` plus this graph's slot.
+    std::vector<TaskGraphSubmit>       submits;          //!< Recorded `TaskSubmit` calls in order.
+    std::vector<TaskHandle>            run_tasks;        //!< Submitted tasks and continuations, everything a replay waits on.
+
+    // Critical Path Scheduling
+
+    TaskGraphSchedule           schedule;               //!< How ready tasks are dispatched.
+    std::vector<TaskHandle>     parents;                //!< The parent of each recorded task, `NullTaskHandle` if none.
+    std::vector<std::uint32_t>  continuation_offsets;   //!< Task `i`'s continuations are `continuations[continuation_offsets[i]]` to `continuations[continuation_offsets[i + 1] - 1]`.
+    std::vector<TaskHandle>     continuations;          //!< The continuations of every recorded task.
+    std::vector<TaskHandle>     bottom_level_order;     //!< Every task comes after its continuations and its parent.
+    std::vector<float>          cost_hints;             //!< From `TaskSetCostHint`, empty if no task was given a hint.
+    std::vector<float>          measured_costs;         //!< Nanoseconds each task took during the last critical path replay.
+    std::vector<float>          bottom_levels;          //!< Cost of the longest path from the start of each task to the end of the graph.
+    std::mutex                  ready_mutex;            //!< Protects `ready_tasks`.
+    std::vector<TaskHandle>     ready_tasks;            //!< Max heap on `bottom_levels` of tasks waiting for a dispatcher.
+    std::atomic<TaskHandleType> num_dispatchers_used;   //!< Dispatchers handed out by the current replay.
+  };
+
   struct ThreadLocalState
   {
-    SPMCDeque<TaskPtr>  normal_queue;
-    SPMCDeque<TaskPtr>  worker_queue;
-    TaskPool            task_allocator;
-    TaskHandle*         allocated_tasks;
-    TaskHandleType      num_allocated_tasks;
-    ThreadLocalState*   last_stolen_worker;
-    pcg_state_setseq_64 rng_state;
-    std::thread         thread_id;
+    SPMCDeque<TaskPtr>                    normal_queue;
+    SPMCDeque<TaskPtr>                    worker_queue;
+    TaskPool                              task_allocator;
+    TaskHandle*                           allocated_tasks;
+    TaskHandleType                        num_allocated_tasks;
+    ThreadLocalState*                     last_stolen_worker;
+    pcg_state_setseq_64                   rng_state;
+    RandomStream                          task_rng;
+    std::thread                           thread_id;
+    TaskGraph*                            recording;
+    detail::LatentFork*                   oldest_latent_fork;    //!< The next fork a heartbeat promotes.
+    detail::LatentFork*                   newest_latent_fork;    //!< New latent forks are linked after this one.
+    std::uint32_t                         heartbeat_polls_left;  //!< Polls until the clock is next read.
+    std::chrono::steady_clock::time_point next_heartbeat;
+    PrivateDeque<TaskPtr>                 private_normal_queue;  //!< Used instead of `normal_queue` if `uses_private_deques`.
+    PrivateDeque<TaskPtr>                 private_worker_queue;  //!< Used instead of `worker_queue` if `uses_private_deques`.
+    bool                                  uses_private_deques;   //!< Only for `WorkStealing::PRIVATE_DEQUES` on threads owned by the system.
+
+    // Written by other workers if `uses_private_deques`.
+
+    alignas(k_CachelineSize) std::atomic<WorkerID> steal_request;   //!< The thief waiting on this worker to answer, `k_NoStealRequest` if none.
+    AtomicTaskPtr                                  steal_response;  //!< Written by the victim answering this worker's steal request.
+    std::atomic_bool                               has_tasks;       //!< Whether the private deques hold any tasks, thieves only ask workers that do.
   };
 
   struct InitializationLock
@@ -200,17 +269,19 @@ namespace Job
   {
     // State that wont be changing during the system's runtime.
 
-    ThreadLocalState*    workers;
-    std::uint32_t        num_workers;
-    std::uint32_t        num_owned_workers;
-    std::atomic_uint32_t num_user_threads_setup;
-    std::uint32_t        num_tasks_per_worker;
-    InitializationLock   init_lock;
-    const char*          sys_arch_str;
-    std::size_t          system_alloc_size;
-    std::size_t          system_alloc_alignment;
-    bool                 needs_delete;
-    std::atomic_bool     is_running;
+    ThreadLocalState*                   workers;
+    std::uint32_t                       num_workers;
+    std::uint32_t                       num_owned_workers;
+    std::atomic_uint32_t                num_user_threads_setup;
+    std::uint32_t                       num_tasks_per_worker;
+    InitializationLock                  init_lock;
+    const char*                         sys_arch_str;
+    std::size_t                         system_alloc_size;
+    std::size_t                         system_alloc_alignment;
+    bool                                needs_delete;
+    std::atomic_bool                    is_running;
+    std::chrono::steady_clock::duration heartbeat_interval;
+    std::uint32_t                       heartbeat_polls_per_clock_read;
 
     // Shared Mutable State
 
@@ -218,6 +289,7 @@ namespace Job
     std::mutex              worker_sleep_mutex;
     std::condition_variable worker_sleep_cv;
     std::atomic_uint32_t    num_available_jobs;
+    std::atomic<TaskGraph*> task_graphs[k_MaxTaskGraphs];
   };
 }  // namespace Job
 
@@ -288,6 +360,25 @@ namespace
       return g_JobSystem->workers + worker_id;
     }
 
+    static TaskGraph* GetTaskGraph(const WorkerID owner_id) noexcept
+    {
+      TaskGraph* const graph = g_JobSystem->task_graphs[owner_id - k_TaskGraphIDBase].load(std::memory_order_relaxed);
+
+      JobAssert(graph != nullptr, "The task belongs to a destroyed task graph.");
+
+      return graph;
+    }
+
+    static const TaskPool& GetTaskPool(const WorkerID owner_id) noexcept
+    {
+      if (owner_id < k_TaskGraphIDBase)
+      {
+        return GetWorker(owner_id)->task_allocator;
+      }
+
+      return GetTaskGraph(owner_id)->pool;
+    }
+
   }  // namespace system
 
   namespace task_pool
@@ -343,8 +434,7 @@ namespace
     {
       if (!ptr.isNull())
       {
-        ThreadLocalState* const worker = system::GetWorker(ptr.worker_id);
-        Task* const             result = task_pool::TaskFromIndex(worker->task_allocator, ptr.task_index);
+        Task* const result = task_pool::TaskFromIndex(system::GetTaskPool(ptr.worker_id), ptr.task_index);
 
         JobAssert(ptr.worker_id == result->owning_worker, "Corrupted worker ID.");
 
@@ -398,8 +488,7 @@ namespace
     {
       if (self)
       {
-        const ThreadLocalState& worker     = *system::GetWorker(self->owning_worker);
-        const TaskHandle        self_index = task_pool::TaskToIndex(worker.task_allocator, self);
+        const TaskHandle self_index = task_pool::TaskToIndex(system::GetTaskPool(self->owning_worker), self);
 
         return TaskPtr{self->owning_worker, self_index};
       }
@@ -451,11 +540,124 @@ namespace
       return worker == g_JobSystem->workers;
     }
 
-    static bool TryRunTask(ThreadLocalState* const worker) noexcept
+    static TaskPtr PendingStealResponse() noexcept
     {
-      const bool is_main_thread = IsMainThread(worker);
+      return TaskPtr{NullTaskHandle, 0u};
+    }
+
+    static bool IsPendingStealResponse(const TaskPtr task_ptr) noexcept
+    {
+      return task_ptr.worker_id == NullTaskHandle && !task_ptr.isNull();
+    }
 
+    static void UpdateHasTasks(ThreadLocalState* const worker) noexcept
+    {
+      const bool has_tasks = !worker->private_normal_queue.IsEmpty() || !worker->private_worker_queue.IsEmpty();
+
+      if (worker->has_tasks.load(std::memory_order_relaxed) != has_tasks)
+      {
+        worker->has_tasks.store(has_tasks, std::memory_order_relaxed);
+      }
+    }
+
+    // Polling point for workers that use private deques, gives the oldest task to the waiting thief (if any).
+    static void AnswerStealRequest(ThreadLocalState* const worker) noexcept
+    {
+      if (worker->steal_request.load(std::memory_order_relaxed) == k_NoStealRequest)
+      {
+        return;
+      }
+
+      const WorkerID thief_id = worker->steal_request.exchange(k_NoStealRequest, std::memory_order_acquire);
+
+      // The thief gave up waiting.
+      if (thief_id == k_NoStealRequest)
+      {
+        return;
+      }
+
+      ThreadLocalState* const thief    = system::GetWorker(thief_id);
+      TaskPtr                 task_ptr = nullptr;
+
+      if (!worker->private_normal_queue.PopOldest(&task_ptr) && !IsMainThread(thief))
+      {
+        worker->private_worker_queue.PopOldest(&task_ptr);
+      }
+
+      UpdateHasTasks(worker);
+
+      thief->steal_response.store(task_ptr, std::memory_order_release);
+    }
+
+    static TaskPtr RequestSteal(ThreadLocalState* const thief, ThreadLocalState* const victim) noexcept
+    {
+      if (!victim->has_tasks.load(std::memory_order_relaxed))
+      {
+        return nullptr;
+      }
+
+      const WorkerID thief_id   = WorkerID(thief - g_JobSystem->workers);
+      WorkerID       no_request = k_NoStealRequest;
+
+      thief->steal_response.store(PendingStealResponse(), std::memory_order_relaxed);
+
+      // Only a single thief waits on a victim at a time.
+      if (!victim->steal_request.compare_exchange_strong(no_request, thief_id, std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        return nullptr;
+      }
+
+      for (std::uint32_t spin = 0u; spin < k_StealRequestMaxSpins; ++spin)
+      {
+        const TaskPtr response = thief->steal_response.load(std::memory_order_acquire);
+
+        if (!IsPendingStealResponse(response))
+        {
+          return response;
+        }
+
+        // Some other thief may be waiting on this worker.
+        AnswerStealRequest(thief);
+        Job::PauseProcessor();
+      }
+
+      // NOTE(SR):
+      //   The victim is stuck in a long task, take the request back unless
+      //   the victim has already claimed it in which case the answer is on its way.
+      WorkerID request = thief_id;
+
+      if (victim->steal_request.compare_exchange_strong(request, k_NoStealRequest, std::memory_order_relaxed, std::memory_order_relaxed))
+      {
+        return nullptr;
+      }
+
+      TaskPtr response = thief->steal_response.load(std::memory_order_acquire);
+
+      while (IsPendingStealResponse(response))
+      {
+        Job::PauseProcessor();
+        response = thief->steal_response.load(std::memory_order_acquire);
+      }
+
+      return response;
+    }
+
+    static TaskPtr PopOwnTask(ThreadLocalState* const worker, const bool is_main_thread) noexcept
+    {
       TaskPtr task_ptr = nullptr;
+
+      if (worker->uses_private_deques)
+      {
+        AnswerStealRequest(worker);
+
+        if (worker->private_normal_queue.Pop(&task_ptr) || (!is_main_thread && worker->private_worker_queue.Pop(&task_ptr)))
+        {
+          UpdateHasTasks(worker);
+        }
+
+        return task_ptr;
+      }
+
       worker->normal_queue.Pop(&task_ptr);
 
       if (task_ptr.isNull() && !is_main_thread)
@@ -463,32 +665,47 @@ namespace
         worker->worker_queue.Pop(&task_ptr);
       }
 
-      const auto TrySteal = [is_main_thread, worker](ThreadLocalState* const other_worker) -> TaskPtr {
-        TaskPtr result = nullptr;
+      return task_ptr;
+    }
 
-        if (other_worker != worker)
+    static TaskPtr TrySteal(ThreadLocalState* const worker, ThreadLocalState* const other_worker, const bool is_main_thread) noexcept
+    {
+      TaskPtr result = nullptr;
+
+      if (other_worker != worker)
+      {
+        if (other_worker->uses_private_deques)
         {
-          other_worker->normal_queue.Steal(&result);
+          return RequestSteal(worker, other_worker);
+        }
 
-          if (result.isNull() && !is_main_thread)
-          {
-            other_worker->worker_queue.Steal(&result);
-          }
+        other_worker->normal_queue.Steal(&result);
+
+        if (result.isNull() && !is_main_thread)
+        {
+          other_worker->worker_queue.Steal(&result);
         }
+      }
 
-        return result;
-      };
+      return result;
+    }
+
+    static bool TryRunTask(ThreadLocalState* const worker) noexcept
+    {
+      const bool is_main_thread = IsMainThread(worker);
+
+      TaskPtr task_ptr = PopOwnTask(worker, is_main_thread);
 
       if (task_ptr.isNull())
       {
-        task_ptr = TrySteal(worker->last_stolen_worker);
+        task_ptr = TrySteal(worker, worker->last_stolen_worker, is_main_thread);
       }
 
       if (task_ptr.isNull())
       {
         Job::ThreadLocalState* const random_worker = RandomWorker(worker);
 
-        task_ptr = TrySteal(random_worker);
+        task_ptr = TrySteal(worker, random_worker, is_main_thread);
 
         if (task_ptr.isNull())
         {
@@ -501,7 +718,11 @@ namespace
       g_JobSystem->num_available_jobs.fetch_sub(1, std::memory_order_relaxed);
 
       Task* const task = task::TaskPtrToPointer(task_ptr);
+
+      // Tasks run while a thread helps out must not be captured by its recording.
+      TaskGraph* const recording = std::exchange(worker->recording, nullptr);
       task::RunTaskFunction(task);
+      worker->recording = recording;
 
       return true;
     }
@@ -621,8 +842,243 @@ namespace
         }
       }
     }
+
+    static void SubmitQPushHelper(const TaskPtr task_ptr, ThreadLocalState* const worker, PrivateDeque<TaskPtr>* queue) noexcept
+    {
+      if (!queue->Push(task_ptr))
+      {
+        system::WakeUpAllWorkers();
+        while (!queue->Push(task_ptr))
+        {
+          worker::TryRunTask(worker);
+        }
+      }
+
+      worker::UpdateHasTasks(worker);
+
+      // Submitting is a polling point too so tasks that spawn work keep thieves fed.
+      worker::AnswerStealRequest(worker);
+    }
   }  // namespace task
 
+  namespace task_graph
+  {
+    static Task* RecordTaskMake(TaskGraph* const graph, const TaskFn function, Task* const parent) noexcept
+    {
+      JobAssert(graph->num_tasks < graph->max_tasks, "Too many tasks recorded, increase `max_tasks` passed to `BeginRecord`.");
+      JobAssert(parent == nullptr || parent->owning_worker == graph->id, "The parent of a recorded task must be recorded too.");
+
+      TaskMemoryBlock* const block = &graph->tasks[graph->num_tasks++];
+      Task* const            task  = new (block) Task(graph->id, function, task::PointerToTaskPtr(parent));
+
+      if (parent)
+      {
+        parent->num_unfinished_tasks.fetch_add(1u, std::memory_order_relaxed);
+      }
+
+      return task;
+    }
+
+    static Task* TaskAt(const TaskMemoryBlock* const tasks, const TaskHandle index) noexcept
+    {
+      return reinterpret_cast<Task*>(const_cast<unsigned char*>(tasks[index].storage));
+    }
+
+    static float TaskCost(const TaskGraph* const graph, const TaskHandle index) noexcept
+    {
+      return graph->cost_hints.empty() ? graph->measured_costs[index] : graph->cost_hints[index];
+    }
+
+    // Bottom level of a task is its cost plus the largest of its continuations' bottom levels
+    // and what is left after its parent finishes (the parent's bottom level less its own cost).
+    static void ComputeBottomLevels(TaskGraph* const graph) noexcept
+    {
+      std::vector<float>& bottom_levels = graph->bottom_levels;
+
+      for (const TaskHandle index : graph->bottom_level_order)
+      {
+        const TaskHandle parent    = graph->parents[index];
+        float            remaining = parent != NullTaskHandle ? bottom_levels[parent] - TaskCost(graph, parent) : 0.0f;
+
+        for (std::uint32_t i = graph->continuation_offsets[index]; i < graph->continuation_offsets[index + 1u]; ++i)
+        {
+          remaining = std::max(remaining, bottom_levels[graph->continuations[i]]);
+        }
+
+        bottom_levels[index] = TaskCost(graph, index) + remaining;
+      }
+    }
+
+    static void BuildCriticalPathInfo(TaskGraph* const graph) noexcept
+    {
+      const TaskHandleType num_tasks = graph->num_tasks;
+
+      std::vector<std::vector<TaskHandle>> dependents(num_tasks);
+      std::vector<std::uint32_t>           num_unvisited(num_tasks, 0u);
+
+      graph->parents.resize(num_tasks);
+      graph->continuation_offsets.assign(num_tasks + 1u, 0u);
+      graph->continuations.clear();
+
+      for (TaskHandle index = 0u; index < num_tasks; ++index)
+      {
+        const Task* const task = TaskAt(graph->tasks.get(), index);
+
+        graph->parents[index]              = task->parent.isNull() ? NullTaskHandle : task->parent.task_index;
+        graph->continuation_offsets[index] = std::uint32_t(graph->continuations.size());
+
+        if (!task->parent.isNull())
+        {
+          dependents[task->parent.task_index].push_back(index);
+          ++num_unvisited[index];
+        }
+
+        for (TaskPtr continuation = task->first_continuation.load(std::memory_order_relaxed); !continuation.isNull(); continuation = TaskAt(graph->tasks.get(), continuation.task_index)->next_continuation)
+        {
+          graph->continuations.push_back(continuation.task_index);
+          dependents[continuation.task_index].push_back(index);
+          ++num_unvisited[index];
+        }
+      }
+      graph->continuation_offsets[num_tasks] = std::uint32_t(graph->continuations.size());
+
+      graph->bottom_level_order.clear();
+
+      for (TaskHandle index = 0u; index < num_tasks; ++index)
+      {
+        if (num_unvisited[index] == 0u)
+        {
+          graph->bottom_level_order.push_back(index);
+        }
+      }
+
+      for (std::size_t i = 0u; i < graph->bottom_level_order.size(); ++i)
+      {
+        for (const TaskHandle dependent : dependents[graph->bottom_level_order[i]])
+        {
+          if (--num_unvisited[dependent] == 0u)
+          {
+            graph->bottom_level_order.push_back(dependent);
+          }
+        }
+      }
+
+      JobAssert(graph->bottom_level_order.size() == num_tasks, "Recorded continuations form a cycle.");
+
+      graph->measured_costs.assign(num_tasks, 1.0f);
+      graph->bottom_levels.assign(num_tasks, 0.0f);
+      ComputeBottomLevels(graph);
+    }
+
+    static bool ReadyTaskLess(const TaskGraph* const graph, const TaskHandle a, const TaskHandle b) noexcept
+    {
+      return graph->bottom_levels[a] < graph->bottom_levels[b];
+    }
+
+    // Queued in place of a ready task, runs whichever ready task has the highest bottom level.
+    static void DispatchReadyTask(Task* const dispatcher) noexcept
+    {
+      TaskGraph* const graph = system::GetTaskGraph(dispatcher->owning_worker);
+      TaskHandle       index;
+
+      {
+        std::lock_guard<std::mutex> lock(graph->ready_mutex);
+
+        std::pop_heap(graph->ready_tasks.begin(), graph->ready_tasks.end(), [graph](const TaskHandle a, const TaskHandle b) { return ReadyTaskLess(graph, a, b); });
+        index = graph->ready_tasks.back();
+        graph->ready_tasks.pop_back();
+      }
+
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      task::RunTaskFunction(TaskAt(graph->tasks.get(), index));
+
+      graph->measured_costs[index] = float(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    static Task* PushReadyTask(TaskGraph* const graph, Task* const task) noexcept
+    {
+      const TaskHandle     index      = task_pool::TaskToIndex(graph->pool, task);
+      const TaskHandleType dispatcher = graph->num_dispatchers_used.fetch_add(1u, std::memory_order_relaxed);
+
+      JobAssert(index < graph->num_tasks && dispatcher < graph->num_dispatchers, "Only recorded tasks are dispatched by priority, each at most once per replay.");
+
+      {
+        std::lock_guard<std::mutex> lock(graph->ready_mutex);
+
+        graph->ready_tasks.push_back(index);
+        std::push_heap(graph->ready_tasks.begin(), graph->ready_tasks.end(), [graph](const TaskHandle a, const TaskHandle b) { return ReadyTaskLess(graph, a, b); });
+      }
+
+      return TaskAt(graph->tasks.get(), graph->num_tasks + dispatcher);
+    }
+  }  // namespace task_graph
+
+  namespace heartbeat
+  {
+    static void LinkNewest(ThreadLocalState* const worker, detail::LatentFork* const fork) noexcept
+    {
+      fork->older     = worker->newest_latent_fork;
+      fork->newer     = nullptr;
+      fork->is_latent = true;
+
+      (fork->older ? fork->older->newer : worker->oldest_latent_fork) = fork;
+      worker->newest_latent_fork                                       = fork;
+    }
+
+    static void LinkOldest(ThreadLocalState* const worker, detail::LatentFork* const fork) noexcept
+    {
+      fork->older     = nullptr;
+      fork->newer     = worker->oldest_latent_fork;
+      fork->is_latent = true;
+
+      (fork->newer ? fork->newer->older : worker->newest_latent_fork) = fork;
+      worker->oldest_latent_fork                                       = fork;
+    }
+
+    static void Unlink(ThreadLocalState* const worker, detail::LatentFork* const fork) noexcept
+    {
+      (fork->older ? fork->older->newer : worker->oldest_latent_fork) = fork->newer;
+      (fork->newer ? fork->newer->older : worker->newest_latent_fork) = fork->older;
+
+      fork->is_latent = false;
+    }
+
+    static void Beat(ThreadLocalState* const worker) noexcept
+    {
+      JobSystemContext* const job_system = g_JobSystem;
+
+      worker->heartbeat_polls_left = job_system->heartbeat_polls_per_clock_read;
+
+      detail::LatentFork* const oldest = worker->oldest_latent_fork;
+
+      // Recorded tasks must not depend on timing.
+      if (!oldest || worker->recording)
+      {
+        return;
+      }
+
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+      if (now < worker->next_heartbeat)
+      {
+        return;
+      }
+
+      worker->next_heartbeat = now + job_system->heartbeat_interval;
+
+      // NOTE(SR):
+      //   Unlinked while being promoted since making and submitting the task may run
+      //   other tasks on this worker which poll, those must not promote the same fork.
+      Unlink(worker, oldest);
+
+      if (oldest->promote(oldest))
+      {
+        LinkOldest(worker, oldest);
+      }
+    }
+  }  // namespace heartbeat
+
   static bool IsPointerAligned(const void* const ptr, const std::size_t alignment) noexcept
   {
     return (reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1u)) == 0u;
@@ -691,6 +1147,34 @@ namespace
     return (value & (value - 1)) == 0;
   }
 
+  namespace asymmetric_fence
+  {
+#if HAS_MEMBARRIER
+    static long Membarrier(const int cmd) noexcept
+    {
+      return syscall(SYS_membarrier, cmd, 0u, 0);
+    }
+#endif
+
+    // NOTE(SR):
+    //   Must succeed before any deque is initialized to use asymmetric fences,
+    //   registering again on a later `Job::Initialize` is harmless.
+    static bool Register() noexcept
+    {
+#if IS_WINDOWS
+      return true;
+#elif HAS_MEMBARRIER
+      const long supported_cmds = Membarrier(MEMBARRIER_CMD_QUERY);
+
+      return supported_cmds >= 0 &&
+             (supported_cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0 &&
+             Membarrier(MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED) == 0;
+#else
+      return false;
+#endif
+    }
+  }  // namespace asymmetric_fence
+
   namespace config
   {
     static Job::WorkerID WorkerCount(const Job::JobSystemCreateOptions& options) noexcept
@@ -711,6 +1195,21 @@ namespace
     {
       return num_tasks_per_worker * num_threads;
     }
+
+    // NOTE(SR):
+    //   The main and user threads run code outside of tasks so cannot be relied on
+    //   to answer steal requests, they keep the shared deques.
+    static bool UsesPrivateDeques(const Job::JobSystemCreateOptions& options, const Job::WorkerID worker_index, const Job::WorkerID num_owned_threads) noexcept
+    {
+      return options.work_stealing == Job::WorkStealing::PRIVATE_DEQUES && worker_index != 0u && worker_index < num_owned_threads;
+    }
+
+    static Job::WorkerID NumPrivateDequeWorkers(const Job::JobSystemCreateOptions& options, const Job::WorkerID num_threads) noexcept
+    {
+      const Job::WorkerID num_owned_threads = num_threads - options.num_user_threads;
+
+      return options.work_stealing == Job::WorkStealing::PRIVATE_DEQUES && num_owned_threads > 1u ? num_owned_threads - 1u : 0u;
+    }
   }  // namespace config
 
 }  // namespace
@@ -729,12 +1228,14 @@ Job::JobSystemMemoryRequirements::JobSystemMemoryRequirements(const JobSystemCre
   const WorkerID      num_threads          = config::WorkerCount(options);
   const std::uint16_t num_tasks_per_worker = config::NumTasksPerWorker(options);
   const std::uint32_t total_num_tasks      = config::TotalNumTasks(num_threads, num_tasks_per_worker);
+  const std::uint32_t num_private_tasks    = config::TotalNumTasks(config::NumPrivateDequeWorkers(options, num_threads), num_tasks_per_worker);
 
   MemoryRequirementsPush<JobSystemContext>(this, 1u);
   MemoryRequirementsPush<ThreadLocalState>(this, num_threads);
   MemoryRequirementsPush<TaskMemoryBlock>(this, total_num_tasks);
   MemoryRequirementsPush<TaskPtr>(this, options.main_queue_size);
-  MemoryRequirementsPush<AtomicTaskPtr>(this, total_num_tasks);
+  MemoryRequirementsPush<AtomicTaskPtr>(this, total_num_tasks - num_private_tasks);
+  MemoryRequirementsPush<TaskPtr>(this, num_private_tasks);
   MemoryRequirementsPush<TaskHandle>(this, total_num_tasks);
 }
 
@@ -758,14 +1259,17 @@ Job::InitializationToken Job::Initialize(const Job::JobSystemMemoryRequirements&
   const WorkerID                owned_threads        = num_threads - options.num_user_threads;
   const std::uint16_t           num_tasks_per_worker = config::NumTasksPerWorker(options);
   const std::uint32_t           total_num_tasks      = config::TotalNumTasks(num_threads, num_tasks_per_worker);
-
-  void*                  alloc_ptr        = memory;
-  JobSystemContext*      job_system       = LinearAlloc<JobSystemContext>(alloc_ptr, 1u).ptr;
-  Span<ThreadLocalState> all_workers      = LinearAlloc<ThreadLocalState>(alloc_ptr, num_threads);
-  Span<TaskMemoryBlock>  all_tasks        = LinearAlloc<TaskMemoryBlock>(alloc_ptr, total_num_tasks);
-  Span<TaskPtr>          main_tasks_ptrs  = LinearAlloc<TaskPtr>(alloc_ptr, options.main_queue_size);
-  Span<AtomicTaskPtr>    worker_task_ptrs = LinearAlloc<AtomicTaskPtr>(alloc_ptr, total_num_tasks);
-  Span<TaskHandle>       all_task_handles = LinearAlloc<TaskHandle>(alloc_ptr, total_num_tasks);
+  const std::uint32_t           num_private_tasks    = config::TotalNumTasks(config::NumPrivateDequeWorkers(options, num_threads), num_tasks_per_worker);
+  const bool                    asymmetric_fences    = options.work_stealing == WorkStealing::ASYMMETRIC_FENCES && asymmetric_fence::Register();
+
+  void*                  alloc_ptr                = memory;
+  JobSystemContext*      job_system               = LinearAlloc<JobSystemContext>(alloc_ptr, 1u).ptr;
+  Span<ThreadLocalState> all_workers              = LinearAlloc<ThreadLocalState>(alloc_ptr, num_threads);
+  Span<TaskMemoryBlock>  all_tasks                = LinearAlloc<TaskMemoryBlock>(alloc_ptr, total_num_tasks);
+  Span<TaskPtr>          main_tasks_ptrs          = LinearAlloc<TaskPtr>(alloc_ptr, options.main_queue_size);
+  Span<AtomicTaskPtr>    worker_task_ptrs         = LinearAlloc<AtomicTaskPtr>(alloc_ptr, total_num_tasks - num_private_tasks);
+  Span<TaskPtr>          private_worker_task_ptrs = LinearAlloc<TaskPtr>(alloc_ptr, num_private_tasks);
+  Span<TaskHandle>       all_task_handles         = LinearAlloc<TaskHandle>(alloc_ptr, total_num_tasks);
 
   job_system->main_queue.Initialize(SpanAlloc(&main_tasks_ptrs, options.main_queue_size), options.main_queue_size);
   job_system->workers           = all_workers.ptr;
@@ -779,6 +1283,14 @@ Job::InitializationToken Job::Initialize(const Job::JobSystemMemoryRequirements&
   job_system->system_alloc_size      = memory_requirements.byte_size;
   job_system->system_alloc_alignment = memory_requirements.alignment;
   job_system->init_lock.num_workers_ready.store(1u, std::memory_order_relaxed);  // Main thread already initialized.
+  job_system->heartbeat_interval             = std::chrono::microseconds(options.heartbeat_us);
+  job_system->heartbeat_polls_per_clock_read = options.heartbeat_us == 0u ? 1u : k_HeartbeatPollsPerClockRead;
+
+  for (std::atomic<TaskGraph*>& task_graph_slot : job_system->task_graphs)
+  {
+    task_graph_slot.store(nullptr, std::memory_order_relaxed);
+  }
+  job_system->is_running.store(num_threads == 1u, std::memory_order_relaxed);  // With no other threads to wait on the system is running right away.
 
 #if IS_WINDOWS
   SYSTEM_INFO sysinfo;
@@ -826,13 +1338,32 @@ Job::InitializationToken Job::Initialize(const Job::JobSystemMemoryRequirements&
   {
     ThreadLocalState* const worker = SpanAlloc(&all_workers, 1u);
 
-    worker->normal_queue.Initialize(SpanAlloc(&worker_task_ptrs, options.normal_queue_size), options.normal_queue_size);
-    worker->worker_queue.Initialize(SpanAlloc(&worker_task_ptrs, options.worker_queue_size), options.worker_queue_size);
+    worker->uses_private_deques = config::UsesPrivateDeques(options, WorkerID(worker_index), owned_threads);
+
+    if (worker->uses_private_deques)
+    {
+      worker->private_normal_queue.Initialize(SpanAlloc(&private_worker_task_ptrs, options.normal_queue_size), options.normal_queue_size);
+      worker->private_worker_queue.Initialize(SpanAlloc(&private_worker_task_ptrs, options.worker_queue_size), options.worker_queue_size);
+    }
+    else
+    {
+      worker->normal_queue.Initialize(SpanAlloc(&worker_task_ptrs, options.normal_queue_size), options.normal_queue_size, asymmetric_fences);
+      worker->worker_queue.Initialize(SpanAlloc(&worker_task_ptrs, options.worker_queue_size), options.worker_queue_size, asymmetric_fences);
+    }
     task_pool::Initialize(&worker->task_allocator, SpanAlloc(&all_tasks, num_tasks_per_worker), num_tasks_per_worker);
     worker->allocated_tasks     = SpanAlloc(&all_task_handles, num_tasks_per_worker);
     worker->num_allocated_tasks = 0u;
     pcg32_srandom_r(&worker->rng_state, worker_index + rng_seed, worker_index * 2u + 1u + rng_seed);
-    worker->last_stolen_worker = main_thread_worker;
+    worker->task_rng             = RandomStream(options.task_rng_seed, worker_index);
+    worker->last_stolen_worker   = main_thread_worker;
+    worker->recording            = nullptr;
+    worker->oldest_latent_fork   = nullptr;
+    worker->newest_latent_fork   = nullptr;
+    worker->heartbeat_polls_left = job_system->heartbeat_polls_per_clock_read;
+    worker->next_heartbeat       = std::chrono::steady_clock::now() + job_system->heartbeat_interval;
+    worker->steal_request.store(k_NoStealRequest, std::memory_order_relaxed);
+    worker->steal_response.store(nullptr, std::memory_order_relaxed);
+    worker->has_tasks.store(false, std::memory_order_relaxed);
   }
 
   g_JobSystem     = job_system;
@@ -848,6 +1379,7 @@ Job::InitializationToken Job::Initialize(const Job::JobSystemMemoryRequirements&
   JobAssert(all_tasks.num_elements == 0u, "All elements expected to be allocated out.");
   JobAssert(main_tasks_ptrs.num_elements == 0u, "All elements expected to be allocated out.");
   JobAssert(worker_task_ptrs.num_elements == 0u, "All elements expected to be allocated out.");
+  JobAssert(private_worker_task_ptrs.num_elements == 0u, "All elements expected to be allocated out.");
   JobAssert(all_task_handles.num_elements == 0u, "All elements expected to be allocated out.");
 
   return Job::InitializationToken{owned_threads};
@@ -948,6 +1480,8 @@ void Job::Shutdown() noexcept
   JobSystemContext* const job_system  = g_JobSystem;
   const std::uint32_t     num_workers = job_system->num_owned_workers;
 
+  JobAssert(std::all_of(std::begin(job_system->task_graphs), std::end(job_system->task_graphs), [](const std::atomic<TaskGraph*>& slot) { return slot.load(std::memory_order_relaxed) == nullptr; }), "Every task graph must be destroyed before shutdown.");
+
   // Incase all threads are not initialized by the time shutdown is called.
   while (job_system->is_running.load(std::memory_order_relaxed) != true) {}
 
@@ -989,6 +1523,11 @@ Task* Job::TaskMake(const TaskFn function, Task* const parent) noexcept
   ThreadLocalState* const worker               = system::GetWorker(worker_id);
   const std::uint32_t     max_tasks_per_worker = g_JobSystem->num_tasks_per_worker;
 
+  if (worker->recording)
+  {
+    return task_graph::RecordTaskMake(worker->recording, function, parent);
+  }
+
   if (worker->num_allocated_tasks == max_tasks_per_worker)
   {
     worker::GarbageCollectAllocatedTasks(worker);
@@ -1040,6 +1579,7 @@ void Job::TaskAddContinuation(Task* const self, Task* const continuation, const
   JobAssert(self->q_type == k_InvalidQueueType, "The parent task should not have already been submitted to a queue.");
   JobAssert(continuation->q_type == k_InvalidQueueType, "A continuation must not have already been submitted to a queue or already added as a continuation.");
   JobAssert(continuation->next_continuation.isNull(), "A continuation must not have already been added to another task.");
+  JobAssert(!IsRecording() || (self->owning_worker >= k_TaskGraphIDBase && self->owning_worker == continuation->owning_worker), "Recorded tasks may only be linked to other tasks in the same recording.");
 
   const TaskPtr new_head          = task::PointerToTaskPtr(continuation);
   continuation->q_type            = queue;
@@ -1083,16 +1623,42 @@ void Job::TaskSubmit(Task* const self, QueueType queue) noexcept
     queue = QueueType::NORMAL;
   }
 
-  ThreadLocalState* const worker   = worker::GetCurrent();
-  const TaskPtr           task_ptr = task::PointerToTaskPtr(self);
+  ThreadLocalState* const worker      = worker::GetCurrent();
+  Task*                   queued_task = self;
 
-  self->q_type = queue;
+  if (self->owning_worker >= k_TaskGraphIDBase)
+  {
+    TaskGraph* const graph = system::GetTaskGraph(self->owning_worker);
+
+    if (worker->recording == graph)
+    {
+      graph->submits.push_back(TaskGraphSubmit{task_pool::TaskToIndex(graph->pool, self), queue});
+      return;
+    }
+
+    if (queue == QueueType::NORMAL && graph->schedule == TaskGraphSchedule::CRITICAL_PATH)
+    {
+      self->q_type = queue;
+      queued_task  = task_graph::PushReadyTask(graph, self);
+    }
+  }
+
+  const TaskPtr task_ptr = task::PointerToTaskPtr(queued_task);
+
+  queued_task->q_type = queue;
 
   switch (queue)
   {
     case QueueType::NORMAL:
     {
-      task::SubmitQPushHelper(task_ptr, worker, &worker->normal_queue);
+      if (worker->uses_private_deques)
+      {
+        task::SubmitQPushHelper(task_ptr, worker, &worker->private_normal_queue);
+      }
+      else
+      {
+        task::SubmitQPushHelper(task_ptr, worker, &worker->normal_queue);
+      }
       break;
     }
     case QueueType::MAIN:
@@ -1114,7 +1680,14 @@ void Job::TaskSubmit(Task* const self, QueueType queue) noexcept
     }
     case QueueType::WORKER:
     {
-      task::SubmitQPushHelper(task_ptr, worker, &worker->worker_queue);
+      if (worker->uses_private_deques)
+      {
+        task::SubmitQPushHelper(task_ptr, worker, &worker->private_worker_queue);
+      }
+      else
+      {
+        task::SubmitQPushHelper(task_ptr, worker, &worker->worker_queue);
+      }
       break;
     }
     default:
@@ -1152,6 +1725,8 @@ void Job::WaitOnTask(const Task* const task) noexcept
 
   ThreadLocalState* const worker = system::GetWorker(worker_id);
 
+  JobAssert(worker->recording == nullptr, "Recorded tasks are not run so cannot be waited on while recording.");
+
   while (!TaskIsDone(task))
   {
     worker::TryRunTask(worker);
@@ -1164,8 +1739,238 @@ void Job::TaskSubmitAndWait(Task* const self, const QueueType queue) noexcept
   WaitOnTask(self);
 }
 
+void Job::BeginRecord(const std::uint16_t max_tasks) noexcept
+{
+  ThreadLocalState* const worker = worker::GetCurrent();
+
+  JobAssert(worker->recording == nullptr, "Already recording on this thread.");
+  JobAssert(max_tasks != 0u && max_tasks <= NullTaskHandle / 2u, "Invalid number of tasks to record.");
+
+  TaskGraph* const graph = new TaskGraph();
+
+  graph->tasks.reset(new TaskMemoryBlock[max_tasks]);
+  graph->pool            = TaskPool{graph->tasks.get(), nullptr};
+  graph->num_tasks       = 0u;
+  graph->max_tasks       = max_tasks;
+  graph->num_dispatchers = 0u;
+  graph->id              = NullTaskHandle;
+  graph->schedule        = TaskGraphSchedule::SUBMISSION_ORDER;
+  graph->num_dispatchers_used.store(0u, std::memory_order_relaxed);
+
+  for (std::size_t slot = 0u; slot < k_MaxTaskGraphs; ++slot)
+  {
+    TaskGraph* empty_slot = nullptr;
+
+    if (g_JobSystem->task_graphs[slot].compare_exchange_strong(empty_slot, graph, std::memory_order_release, std::memory_order_relaxed))
+    {
+      graph->id = WorkerID(k_TaskGraphIDBase + slot);
+      break;
+    }
+  }
+
+  JobAssert(graph->id != NullTaskHandle, "Too many task graphs alive at once.");
+
+  worker->recording = graph;
+}
+
+Job::TaskGraph* Job::EndRecord() noexcept
+{
+  ThreadLocalState* const worker = worker::GetCurrent();
+  TaskGraph* const        graph  = std::exchange(worker->recording, nullptr);
+
+  JobAssert(graph != nullptr, "`EndRecord` called without a matching `BeginRecord`.");
+
+  const TaskHandleType num_tasks       = graph->num_tasks;
+  const TaskHandleType num_dispatchers = num_tasks;
+  const std::size_t    num_blocks      = std::size_t(num_tasks) + num_dispatchers;
+
+  task_graph::BuildCriticalPathInfo(graph);
+
+  std::unique_ptr<TaskMemoryBlock[]> tasks{new TaskMemoryBlock[num_blocks]};
+
+  std::memcpy(tasks.get(), graph->tasks.get(), sizeof(TaskMemoryBlock) * num_tasks);
+
+  for (std::size_t index = num_tasks; index < num_blocks; ++index)
+  {
+    new (&tasks[index]) Task(graph->id, &task_graph::DispatchReadyTask, TaskPtr(nullptr));
+  }
+
+  graph->tasks           = std::move(tasks);
+  graph->pool.memory     = graph->tasks.get();
+  graph->num_dispatchers = num_dispatchers;
+
+  graph->initial_tasks.reset(new TaskMemoryBlock[num_blocks]);
+  std::memcpy(graph->initial_tasks.get(), graph->tasks.get(), sizeof(TaskMemoryBlock) * num_blocks);
+
+  for (const TaskGraphSubmit& submit : graph->submits)
+  {
+    graph->run_tasks.push_back(submit.task);
+  }
+
+  // Continuations had their queue set by `TaskAddContinuation`.
+  for (TaskHandle index = 0u; index < num_tasks; ++index)
+  {
+    if (task_graph::TaskAt(graph->tasks.get(), index)->q_type != k_InvalidQueueType)
+    {
+      graph->run_tasks.push_back(index);
+    }
+  }
+
+  return graph;
+}
+
+bool Job::IsRecording() noexcept
+{
+  return worker::GetCurrent()->recording != nullptr;
+}
+
+void Job::Replay(TaskGraph* const graph) noexcept
+{
+  ThreadLocalState* const worker = worker::GetCurrent();
+
+  JobAssert(worker->recording == nullptr, "Cannot replay a graph while recording.");
+  JobAssert(graph->initial_tasks != nullptr, "The graph is still being recorded.");
+
+  // Only the dispatchers used by the last replay need resetting.
+  const std::size_t num_blocks = std::size_t(graph->num_tasks) + graph->num_dispatchers_used.exchange(0u, std::memory_order_relaxed);
+
+  std::memcpy(graph->tasks.get(), graph->initial_tasks.get(), sizeof(TaskMemoryBlock) * num_blocks);
+
+  for (const TaskGraphSubmit& submit : graph->submits)
+  {
+    TaskSubmit(task_graph::TaskAt(graph->tasks.get(), submit.task), submit.queue);
+  }
+
+  system::WakeUpAllWorkers();
+
+  // NOTE(SR):
+  //   Dropping the reference held since creation is the last write `TaskOnFinish`
+  //   makes to a task, waiting for it rather than `TaskIsDone` means nothing is
+  //   still touching the tasks when the next replay copies over them.
+  for (const TaskHandle index : graph->run_tasks)
+  {
+    const Task* const  task            = task_graph::TaskAt(graph->tasks.get(), index);
+    const std::int32_t final_ref_count = task_graph::TaskAt(graph->initial_tasks.get(), index)->ref_count.load(std::memory_order_relaxed) - 1;
+
+    while (task->ref_count.load(std::memory_order_acquire) != final_ref_count)
+    {
+      worker::TryRunTask(worker);
+    }
+  }
+
+  const TaskHandleType num_dispatchers_used = graph->num_dispatchers_used.load(std::memory_order_relaxed);
+
+  for (TaskHandleType dispatcher = 0u; dispatcher < num_dispatchers_used; ++dispatcher)
+  {
+    const Task* const task = task_graph::TaskAt(graph->tasks.get(), graph->num_tasks + dispatcher);
+
+    while (task->ref_count.load(std::memory_order_acquire) != 0)
+    {
+      worker::TryRunTask(worker);
+    }
+  }
+
+  // Without hints the next replay is prioritized by how long each task took this time.
+  if (graph->schedule == TaskGraphSchedule::CRITICAL_PATH && graph->cost_hints.empty())
+  {
+    task_graph::ComputeBottomLevels(graph);
+  }
+}
+
+std::size_t Job::TaskGraphNumTasks(const TaskGraph* const graph) noexcept
+{
+  return graph->num_tasks;
+}
+
+void Job::TaskSetCostHint(Task* const task, const float cost) noexcept
+{
+  TaskGraph* const graph = worker::GetCurrent()->recording;
+
+  JobAssert(graph != nullptr && task->owning_worker == graph->id, "Cost hints can only be given to tasks being recorded on this thread.");
+
+  if (graph->cost_hints.empty())
+  {
+    graph->cost_hints.assign(graph->max_tasks, 1.0f);
+  }
+
+  graph->cost_hints[task_pool::TaskToIndex(graph->pool, task)] = cost;
+}
+
+void Job::TaskGraphSetSchedule(TaskGraph* const graph, const TaskGraphSchedule schedule) noexcept
+{
+  graph->schedule = schedule;
+}
+
+float Job::TaskGraphCriticalPathCost(const TaskGraph* const graph) noexcept
+{
+  return graph->bottom_levels.empty() ? 0.0f : *std::max_element(graph->bottom_levels.begin(), graph->bottom_levels.end());
+}
+
+void Job::TaskGraphDestroy(TaskGraph* const graph) noexcept
+{
+  if (graph)
+  {
+    JobAssert(worker::GetCurrent()->recording != graph, "Cannot destroy a graph that is still recording, call `EndRecord` first.");
+
+    g_JobSystem->task_graphs[graph->id - k_TaskGraphIDBase].store(nullptr, std::memory_order_relaxed);
+    delete graph;
+  }
+}
+
+RandomStream& Job::TaskRng() noexcept
+{
+  return worker::GetCurrent()->task_rng;
+}
+
 // Member Fn Definitions
 
+// NOTE(SR):
+//   `RandomStream` mirrors `pcg32_random_t` so that the PCG headers
+//   do not need to be part of the public interface.
+
+static_assert(sizeof(RandomStream) == sizeof(pcg32_random_t), "RandomStream expected to have the same layout as pcg32_random_t.");
+
+Job::RandomStream::RandomStream(const std::uint64_t seed, const std::uint64_t stream_id) noexcept
+{
+  pcg32_random_t rng;
+  pcg32_srandom_r(&rng, seed, stream_id);
+
+  state = rng.state;
+  inc   = rng.inc;
+}
+
+std::uint32_t Job::RandomStream::Next() noexcept
+{
+  pcg32_random_t      rng    = {state, inc};
+  const std::uint32_t result = pcg32_random_r(&rng);
+
+  state = rng.state;
+
+  return result;
+}
+
+std::uint32_t Job::RandomStream::NextBounded(const std::uint32_t bound) noexcept
+{
+  pcg32_random_t      rng    = {state, inc};
+  const std::uint32_t result = pcg32_boundedrand_r(&rng, bound);
+
+  state = rng.state;
+
+  return result;
+}
+
+void Job::RandomStream::Fill(std::uint32_t* const out, const std::size_t count) noexcept
+{
+  pcg32_random_t rng = {state, inc};
+
+  for (std::size_t i = 0u; i < count; ++i)
+  {
+    out[i] = pcg32_random_r(&rng);
+  }
+
+  state = rng.state;
+}
+
 Task::Task(WorkerID worker, TaskFn fn, TaskPtr parent) noexcept :
   fn_storage{fn},
   num_unfinished_tasks{1},
@@ -1180,6 +1985,22 @@ Task::Task(WorkerID worker, TaskFn fn, TaskPtr parent) noexcept :
 {
 }
 
+void Job::detail::asymmetricHeavyFence() noexcept
+{
+#if IS_WINDOWS
+  FlushProcessWriteBuffers();
+#elif HAS_MEMBARRIER
+  const long result = asymmetric_fence::Membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED);
+
+  JobAssert(result == 0, "The process must be registered for expedited membarrier before use.");
+  (void)result;
+#else
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+#undef HAS_MEMBARRIER
+
 #if defined(_MSC_VER)
 #define NativePause YieldProcessor
 #elif defined(__clang__) && defined(__SSE__) || defined(__INTEL_COMPILER)  // || defined(__GNUC_PREREQ) && (__GNUC_PREREQ(4, 7) && defined(__SSE__))
@@ -1249,6 +2070,72 @@ bool Job::detail::mainQueueTryRunTask(void) noexcept
   return false;
 }
 
+void Job::detail::latentForkPush(LatentFork* const fork) noexcept
+{
+  ThreadLocalState* const worker = worker::GetCurrent();
+
+  heartbeat::LinkNewest(worker, fork);
+
+  if (--worker->heartbeat_polls_left == 0u)
+  {
+    heartbeat::Beat(worker);
+  }
+}
+
+bool Job::detail::latentForkPop(LatentFork* const fork) noexcept
+{
+  const bool was_latent = fork->is_latent;
+
+  if (was_latent)
+  {
+    heartbeat::Unlink(worker::GetCurrent(), fork);
+  }
+
+  return was_latent;
+}
+
+void Job::detail::latentForkJoin(LatentFork* const fork) noexcept
+{
+  Task* const join_task = fork->join_task;
+
+  if (join_task)
+  {
+    ThreadLocalState* const worker = worker::GetCurrent();
+
+    system::WakeUpAllWorkers();
+
+    // NOTE(SR):
+    //   `join_task` is never submitted, once only its own count is left every
+    //   promoted task has finished and it is run here to be garbage collected.
+    while (join_task->num_unfinished_tasks.load(std::memory_order_acquire) != 1)
+    {
+      worker::TryRunTask(worker);
+    }
+
+    task::RunTaskFunction(join_task);
+  }
+}
+
+Task* Job::detail::latentForkParent(LatentFork* const fork) noexcept
+{
+  if (!fork->join_task)
+  {
+    fork->join_task = TaskMake([](Task* const) {});
+  }
+
+  return fork->join_task;
+}
+
+void Job::detail::heartbeatPoll() noexcept
+{
+  ThreadLocalState* const worker = worker::GetCurrent();
+
+  if (--worker->heartbeat_polls_left == 0u)
+  {
+    heartbeat::Beat(worker);
+  }
+}
+
 #undef IS_WINDOWS
 #undef IS_POSIX
 #undef IS_SINGLE_THREADED
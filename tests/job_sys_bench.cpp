@@ -0,0 +1,1335 @@
+//
+// Shareef Abdoul-Raheem
+// job_sys_bench.cpp
+//
+// Contains scaling benchmarks for the Job System.
+//
+// Usage: BFJobBenchmark [benchmark_name_filter] [max_threads]
+//
+#include "concurrent/job_algorithms.hpp"
+#include "concurrent/job_api.hpp"
+#include "concurrent/job_bytes.hpp"
+#include "concurrent/job_chunked_soa.hpp"
+#include "concurrent/job_data_flow.hpp"
+#include "concurrent/job_execution.hpp"
+#include "concurrent/job_file.hpp"
+#include "concurrent/job_graph.hpp"
+#include "concurrent/job_hash_map.hpp"
+#include "concurrent/job_numeric.hpp"
+#include "concurrent/job_queue.hpp"
+#include "concurrent/job_random.hpp"
+
+#include <algorithm>      // shuffle, min, sort, partition, nth_element, merge, partial_sort_copy, minmax_element, transform, is_sorted
+#include <array>          // array
+#include <atomic>         // atomic
+#include <chrono>         // steady_clock
+#include <cmath>          // abs, sqrt
+#include <cstdio>         // printf, fopen, fwrite, remove
+#include <cstdlib>        // atoi
+#include <cstring>        // strstr, memcpy, memset
+#include <functional>     // greater
+#include <fstream>        // ifstream
+#include <memory>         // unique_ptr, make_unique
+#include <mutex>          // mutex, lock_guard
+#include <numeric>        // iota, partial_sum, reduce
+#include <random>         // mt19937_64
+#include <string>         // string, getline
+#include <unordered_map>  // unordered_map
+#include <vector>         // vector
+
+using BenchClock = std::chrono::steady_clock;
+
+struct BenchOptions
+{
+  std::size_t max_threads;
+};
+
+// Best of `num_runs` in milliseconds.
+template<typename F>
+static double TimeMs(F&& fn, const int num_runs = 3)
+{
+  double best_ms = 1e30;
+
+  for (int i = 0; i < num_runs; ++i)
+  {
+    const BenchClock::time_point start = BenchClock::now();
+    fn();
+    const BenchClock::time_point end = BenchClock::now();
+
+    best_ms = std::min(best_ms, std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  return best_ms;
+}
+
+// Calls `fn(num_threads)` with the job system initialized with 1, 2, 4, ... `options.max_threads` threads.
+template<typename F>
+static void ForEachThreadCount(const BenchOptions& options, F&& fn, Job::JobSystemCreateOptions create_options = {})
+{
+  std::vector<std::size_t> thread_counts;
+
+  for (std::size_t num_threads = 1u; num_threads < options.max_threads; num_threads *= 2u)
+  {
+    thread_counts.push_back(num_threads);
+  }
+  thread_counts.push_back(options.max_threads);
+
+  for (const std::size_t num_threads : thread_counts)
+  {
+    create_options.num_threads = std::uint8_t(num_threads);
+
+    Job::Initialize(Job::JobSystemMemoryRequirements(create_options));
+    fn(num_threads);
+    Job::Shutdown();
+  }
+}
+
+static void BenchShuffle(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumItems   = std::size_t(1) << 24;
+  static constexpr std::size_t k_SampleSize = k_NumItems / 100;
+
+  std::vector<std::uint32_t> data(k_NumItems);
+  std::vector<std::uint32_t> sample(k_SampleSize);
+
+  std::iota(data.begin(), data.end(), 0u);
+
+  std::mt19937_64 serial_rng{1234u};
+  const double    serial_ms = TimeMs([&]() { std::shuffle(data.begin(), data.end(), serial_rng); });
+
+  std::printf("Shuffle of %zu uint32s, std::shuffle: %.2fms\n", k_NumItems, serial_ms);
+  std::printf("  %8s %12s %8s %12s\n", "threads", "shuffle ms", "speedup", "sample(1%) ms");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double shuffle_ms = TimeMs([&]() { Job::ParallelShuffle(data.begin(), data.end(), 1234u); });
+    const double sample_ms  = TimeMs([&]() { Job::ParallelSample(data.begin(), data.end(), sample.begin(), k_SampleSize, 1234u); });
+
+    std::printf("  %8zu %12.2f %7.2fx %12.2f\n", num_threads, shuffle_ms, serial_ms / shuffle_ms, sample_ms);
+  });
+}
+
+static std::uint64_t SerialFib(const int n)
+{
+  return n < 2 ? std::uint64_t(n) : SerialFib(n - 1) + SerialFib(n - 2);
+}
+
+struct BenchSortRange
+{
+  std::uint32_t* first;
+  std::uint32_t* last;
+};
+
+struct BenchBVHRange
+{
+  std::uint32_t first;
+  std::uint32_t last;
+};
+
+static void BenchRecurse(const BenchOptions& options)
+{
+  static constexpr int         k_FibN         = 34;
+  static constexpr int         k_FibCutoff    = 20;
+  static constexpr std::size_t k_NumSortItems = std::size_t(1) << 23;
+  static constexpr std::size_t k_NumBVHPoints = std::size_t(1) << 21;
+  static constexpr std::size_t k_BVHLeafSize  = 4;
+
+  std::vector<std::uint32_t> sort_source(k_NumSortItems);
+  std::vector<std::uint32_t> sort_data(k_NumSortItems);
+  std::vector<float>         points(k_NumBVHPoints * 3u);
+  std::vector<std::uint32_t> bvh_indices(k_NumBVHPoints);
+  std::mt19937_64            rng{42u};
+
+  for (std::uint32_t& value : sort_source)
+  {
+    value = std::uint32_t(rng());
+  }
+
+  for (float& value : points)
+  {
+    value = float(rng() % 100000u) * 0.01f;
+  }
+
+  const auto SortDivide = [](const BenchSortRange& range) {
+    std::uint32_t* const mid = range.first + (range.last - range.first) / 2;
+    std::nth_element(range.first, mid, range.last);
+    return std::array<BenchSortRange, 2>{BenchSortRange{range.first, mid}, BenchSortRange{mid, range.last}};
+  };
+
+  // Median split BVH over points, returns the number of nodes.
+  const auto BVHSplit = [&points, &bvh_indices](const BenchBVHRange& range) {
+    float min[3] = {1e30f, 1e30f, 1e30f};
+    float max[3] = {-1e30f, -1e30f, -1e30f};
+
+    for (std::uint32_t i = range.first; i < range.last; ++i)
+    {
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        min[axis] = std::min(min[axis], points[bvh_indices[i] * 3u + axis]);
+        max[axis] = std::max(max[axis], points[bvh_indices[i] * 3u + axis]);
+      }
+    }
+
+    const float extent[3] = {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+    const int   axis      = extent[0] > extent[1] ? (extent[0] > extent[2] ? 0 : 2) : (extent[1] > extent[2] ? 1 : 2);
+    const auto  mid       = range.first + (range.last - range.first) / 2;
+
+    std::nth_element(bvh_indices.begin() + range.first, bvh_indices.begin() + mid, bvh_indices.begin() + range.last, [&points, axis](const std::uint32_t a, const std::uint32_t b) {
+      return points[a * 3u + axis] < points[b * 3u + axis];
+    });
+
+    return std::array<BenchBVHRange, 2>{BenchBVHRange{range.first, mid}, BenchBVHRange{mid, range.last}};
+  };
+  const auto BVHIsLeaf  = [](const BenchBVHRange& range) { return range.last - range.first <= k_BVHLeafSize; };
+  const auto BVHLeaf    = [](const BenchBVHRange&) { return std::size_t(1u); };
+  const auto BVHCombine = [](const BenchBVHRange&, const std::array<std::size_t, 2>& sub) { return sub[0] + sub[1] + 1u; };
+
+  const auto SerialBVH = [&](const auto& self, const BenchBVHRange& range) -> std::size_t {
+    if (BVHIsLeaf(range))
+    {
+      return BVHLeaf(range);
+    }
+
+    const std::array<BenchBVHRange, 2> sub = BVHSplit(range);
+    return BVHCombine(range, {self(self, sub[0]), self(self, sub[1])});
+  };
+
+  const auto ResetBVH = [&bvh_indices]() { std::iota(bvh_indices.begin(), bvh_indices.end(), 0u); };
+
+  const double fib_serial_ms  = TimeMs([]() { SerialFib(k_FibN); });
+  const double sort_serial_ms = TimeMs([&]() { sort_data = sort_source; std::sort(sort_data.begin(), sort_data.end()); });
+  const double bvh_serial_ms  = TimeMs([&]() { ResetBVH(); SerialBVH(SerialBVH, BenchBVHRange{0u, std::uint32_t(k_NumBVHPoints)}); });
+
+  std::printf("fib(%i) serial: %.2fms, sort of %zu uint32s serial: %.2fms, BVH of %zu points serial: %.2fms\n", k_FibN, fib_serial_ms, k_NumSortItems, sort_serial_ms, k_NumBVHPoints, bvh_serial_ms);
+  std::printf("  %8s %10s %8s %10s %8s %10s %8s\n", "threads", "fib ms", "speedup", "sort ms", "speedup", "bvh ms", "speedup");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double fib_ms = TimeMs([]() {
+      Job::ParallelRecurse(
+       k_FibN,
+       [](const int n) { return n < k_FibCutoff; },
+       [](const int n) { return SerialFib(n); },
+       [](const int n) { return std::array<int, 2>{n - 1, n - 2}; },
+       [](const int, const std::array<std::uint64_t, 2>& sub) { return sub[0] + sub[1]; });
+    });
+
+    const double sort_ms = TimeMs([&]() {
+      sort_data = sort_source;
+      Job::ParallelRecurse(
+       BenchSortRange{sort_data.data(), sort_data.data() + sort_data.size()},
+       [](const BenchSortRange& range) { return range.last - range.first <= 4096; },
+       [](const BenchSortRange& range) { std::sort(range.first, range.last); },
+       SortDivide,
+       [](const BenchSortRange&) {});
+    });
+
+    const double bvh_ms = TimeMs([&]() {
+      ResetBVH();
+      Job::ParallelRecurse(BenchBVHRange{0u, std::uint32_t(k_NumBVHPoints)}, BVHIsLeaf, BVHLeaf, BVHSplit, BVHCombine);
+    });
+
+    std::printf("  %8zu %10.2f %7.2fx %10.2f %7.2fx %10.2f %7.2fx\n", num_threads, fib_ms, fib_serial_ms / fib_ms, sort_ms, sort_serial_ms / sort_ms, bvh_ms, bvh_serial_ms / bvh_ms);
+  });
+}
+
+// Symmetric RMAT graph (Graph500 parameters) with 2^scale vertices and edge_factor * 2^scale undirected edges.
+static void MakeRMATGraph(const int scale, const std::uint32_t edge_factor, std::vector<std::uint64_t>& row_offsets, std::vector<std::uint32_t>& columns)
+{
+  const std::uint32_t num_vertices = std::uint32_t(1u) << scale;
+  const std::size_t   num_edges    = std::size_t(num_vertices) * edge_factor;
+
+  std::vector<std::uint32_t> edge_from(num_edges);
+  std::vector<std::uint32_t> edge_to(num_edges);
+  std::mt19937_64            rng{5u};
+
+  for (std::size_t i = 0u; i < num_edges; ++i)
+  {
+    std::uint32_t from = 0u;
+    std::uint32_t to   = 0u;
+
+    for (int bit = 0; bit < scale; ++bit)
+    {
+      const double quadrant = double(rng() >> 11) * (1.0 / 9007199254740992.0);
+
+      from = (from << 1) | std::uint32_t(quadrant >= 0.76);                     // c + d
+      to   = (to << 1) | std::uint32_t(quadrant >= 0.57 && quadrant < 0.76) |  // b
+           std::uint32_t(quadrant >= 0.95);                                   // d
+    }
+
+    edge_from[i] = from;
+    edge_to[i]   = to;
+  }
+
+  row_offsets.assign(num_vertices + 1u, 0u);
+  columns.resize(num_edges * 2u);
+
+  for (std::size_t i = 0u; i < num_edges; ++i)
+  {
+    ++row_offsets[edge_from[i] + 1u];
+    ++row_offsets[edge_to[i] + 1u];
+  }
+
+  std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+
+  std::vector<std::uint64_t> write_offsets(row_offsets.begin(), row_offsets.end() - 1);
+
+  for (std::size_t i = 0u; i < num_edges; ++i)
+  {
+    columns[write_offsets[edge_from[i]]++] = edge_to[i];
+    columns[write_offsets[edge_to[i]]++]   = edge_from[i];
+  }
+}
+
+static void BenchBFS(const BenchOptions& options)
+{
+  static constexpr int           k_Scale      = 20;
+  static constexpr std::uint32_t k_EdgeFactor = 16u;
+
+  std::vector<std::uint64_t> row_offsets;
+  std::vector<std::uint32_t> columns;
+
+  MakeRMATGraph(k_Scale, k_EdgeFactor, row_offsets, columns);
+
+  const Job::CSRGraph graph = {row_offsets.data(), columns.data(), std::uint32_t(row_offsets.size() - 1u)};
+
+  // Start from the highest degree vertex so the search covers the giant component.
+  std::uint32_t source = 0u;
+  for (std::uint32_t v = 0u; v < graph.num_vertices; ++v)
+  {
+    source = graph.Degree(v) > graph.Degree(source) ? v : source;
+  }
+
+  std::vector<std::int32_t>  levels(graph.num_vertices);
+  std::vector<std::uint32_t> queue;
+  std::size_t                num_reached = 0u;
+
+  const double serial_ms = TimeMs([&]() {
+    std::fill(levels.begin(), levels.end(), -1);
+    queue.assign(1u, source);
+    levels[source] = 0;
+
+    for (std::size_t i = 0u; i < queue.size(); ++i)
+    {
+      for (std::uint64_t edge = graph.row_offsets[queue[i]]; edge < graph.row_offsets[queue[i] + 1u]; ++edge)
+      {
+        if (levels[graph.columns[edge]] < 0)
+        {
+          levels[graph.columns[edge]] = levels[queue[i]] + 1;
+          queue.push_back(graph.columns[edge]);
+        }
+      }
+    }
+
+    num_reached = queue.size();
+  });
+
+  const double edges_traversed = double(graph.NumEdges());
+
+  std::printf("BFS on RMAT scale %i (%u vertices, %llu directed edges, %zu reached), serial: %.2fms (%.1f MTEPS)\n", k_Scale, graph.num_vertices, static_cast<unsigned long long>(graph.NumEdges()), num_reached, serial_ms, edges_traversed / (serial_ms * 1000.0));
+  std::printf("  %8s %12s %8s %12s %8s\n", "threads", "top-down ms", "MTEPS", "dir-opt ms", "MTEPS");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    Job::BFSOptions top_down_options = {};
+    top_down_options.allow_bottom_up = false;
+
+    const double top_down_ms = TimeMs([&]() { Job::ParallelBFS(graph, source, levels.data(), top_down_options); });
+    const double dir_opt_ms  = TimeMs([&]() { Job::ParallelBFS(graph, source, levels.data()); });
+
+    std::printf("  %8zu %12.2f %8.1f %12.2f %8.1f\n", num_threads, top_down_ms, edges_traversed / (top_down_ms * 1000.0), dir_opt_ms, edges_traversed / (dir_opt_ms * 1000.0));
+  });
+}
+
+static void BenchBytes(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumBytes = std::size_t(512u) << 20;
+
+  std::vector<unsigned char> src(k_NumBytes, 1u);
+  std::vector<unsigned char> dst(k_NumBytes, 2u);
+  std::vector<float>         transform_dst(k_NumBytes / sizeof(float));
+
+  // Copies and transforms read and write every byte, fills only write.
+  const auto GBPerSec = [](const double bytes_moved, const double ms) { return bytes_moved / (ms * 1e6); };
+
+  const double memcpy_ms = TimeMs([&]() { std::memcpy(dst.data(), src.data(), k_NumBytes); });
+  const double memset_ms = TimeMs([&]() { std::memset(dst.data(), 3, k_NumBytes); });
+
+  std::printf("%zu MB buffers, memcpy: %.2f GB/s, memset: %.2f GB/s\n", k_NumBytes >> 20, GBPerSec(2.0 * k_NumBytes, memcpy_ms), GBPerSec(double(k_NumBytes), memset_ms));
+  std::printf("  %8s %12s %12s %16s\n", "threads", "copy GB/s", "fill GB/s", "transform GB/s");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double copy_ms      = TimeMs([&]() { Job::TaskSubmitAndWait(Job::ParallelCopy(dst.data(), src.data(), k_NumBytes)); });
+    const double fill_ms      = TimeMs([&]() { Job::TaskSubmitAndWait(Job::ParallelFill(dst.data(), 4u, k_NumBytes)); });
+    const double transform_ms = TimeMs([&]() {
+      const std::uint32_t* const words = reinterpret_cast<const std::uint32_t*>(src.data());
+
+      Job::TaskSubmitAndWait(Job::ParallelTransform(words, transform_dst.size(), transform_dst.data(), [](const std::uint32_t word) { return float(word) * 0.25f; }));
+    });
+
+    std::printf("  %8zu %12.2f %12.2f %16.2f\n", num_threads, GBPerSec(2.0 * k_NumBytes, copy_ms), GBPerSec(double(k_NumBytes), fill_ms), GBPerSec(2.0 * k_NumBytes, transform_ms));
+  });
+}
+
+// Sums the number after the last space of each line, like pulling a latency field out of a log.
+static std::uint64_t BenchParseLogField(const std::string_view line)
+{
+  const std::size_t field_start = line.rfind(' ');
+
+  std::uint64_t value = 0u;
+
+  for (std::size_t i = field_start == std::string_view::npos ? 0u : field_start + 1u; i < line.size(); ++i)
+  {
+    value = value * 10u + std::uint64_t(line[i] - '0');
+  }
+
+  return value;
+}
+
+static void BenchLines(const BenchOptions& options)
+{
+  static constexpr const char* k_Path     = "job_sys_bench_lines.txt";
+  static constexpr std::size_t k_NumBytes = std::size_t(256u) << 20;
+
+  {
+    std::FILE* const file = std::fopen(k_Path, "wb");
+
+    if (!file)
+    {
+      std::printf("Could not create '%s'.\n", k_Path);
+      return;
+    }
+
+    std::mt19937_64 rng{9u};
+    std::string     line;
+    std::size_t     num_bytes = 0u;
+
+    while (num_bytes < k_NumBytes)
+    {
+      line = "2024-01-01T00:00:00Z GET /api/v1/items/" + std::to_string(rng() % 100000u) + " 200 " + std::to_string(rng() % 5000u) + "\n";
+      std::fwrite(line.data(), 1u, line.size(), file);
+      num_bytes += line.size();
+    }
+
+    std::fclose(file);
+  }
+
+  std::uint64_t serial_sum = 0u;
+
+  const double serial_ms = TimeMs([&]() {
+    std::ifstream file{k_Path, std::ios::binary};
+    std::string   line;
+
+    serial_sum = 0u;
+
+    while (std::getline(file, line))
+    {
+      serial_sum += BenchParseLogField(line);
+    }
+  });
+
+  const auto GBPerSec = [](const double ms) { return double(k_NumBytes) / (ms * 1e6); };
+
+  std::printf("%zu MB log, std::getline: %.2fms (%.2f GB/s)\n", k_NumBytes >> 20, serial_ms, GBPerSec(serial_ms));
+  std::printf("  %8s %10s %8s %8s\n", "threads", "ms", "GB/s", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    std::uint64_t parallel_sum = 0u;
+
+    const double parallel_ms = TimeMs([&]() {
+      Job::WorkerLocal<std::uint64_t> sums{0u};
+
+      Job::ParallelForEachLine(k_Path, sums, [](const std::string_view line, std::uint64_t& sum) { sum += BenchParseLogField(line); });
+
+      parallel_sum = sums.Combine([](const std::uint64_t lhs, const std::uint64_t rhs) { return lhs + rhs; });
+    });
+
+    std::printf("  %8zu %10.2f %8.2f %8s\n", num_threads, parallel_ms, GBPerSec(parallel_ms), parallel_sum == serial_sum ? "yes" : "NO");
+  });
+
+  std::remove(k_Path);
+}
+
+static void BenchCrc32c(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumBytes = std::size_t(512u) << 20;
+
+  std::vector<unsigned char> data(k_NumBytes);
+  std::mt19937_64            rng{17u};
+
+  for (unsigned char& byte : data)
+  {
+    byte = static_cast<unsigned char>(rng());
+  }
+
+  std::uint32_t serial_crc = 0u;
+
+  const auto   GBPerSec  = [](const double ms) { return double(k_NumBytes) / (ms * 1e6); };
+  const double serial_ms = TimeMs([&]() { serial_crc = Job::Crc32c(data.data(), k_NumBytes); });
+
+  std::printf("CRC-32C of %zu MB, serial: %.2f GB/s\n", k_NumBytes >> 20, GBPerSec(serial_ms));
+  std::printf("  %8s %10s %8s %8s\n", "threads", "GB/s", "speedup", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    std::uint32_t parallel_crc = 0u;
+
+    const double parallel_ms = TimeMs([&]() { parallel_crc = Job::ParallelCrc32c(data.data(), k_NumBytes); });
+
+    std::printf("  %8zu %10.2f %7.2fx %8s\n", num_threads, GBPerSec(parallel_ms), serial_ms / parallel_ms, parallel_crc == serial_crc ? "yes" : "NO");
+  });
+}
+
+static void BenchMerge(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumRuns  = 16u;
+  static constexpr std::size_t k_RunSize  = std::size_t(1) << 21;
+  static constexpr std::size_t k_NumItems = k_NumRuns * k_RunSize;
+
+  std::vector<std::uint32_t>                      items(k_NumItems);
+  std::vector<std::uint32_t>                      merged(k_NumItems);
+  std::vector<Job::MergeRun<const std::uint32_t*>> runs;
+  std::mt19937_64                                 rng{21u};
+
+  for (std::size_t run = 0u; run < k_NumRuns; ++run)
+  {
+    std::uint32_t* const first = items.data() + run * k_RunSize;
+
+    for (std::size_t i = 0u; i < k_RunSize; ++i)
+    {
+      first[i] = std::uint32_t(rng());
+    }
+
+    std::sort(first, first + k_RunSize);
+    runs.push_back({first, first + k_RunSize});
+  }
+
+  // Serial baseline, pairwise std::merge rounds.
+  std::vector<std::uint32_t> serial_a(k_NumItems);
+  std::vector<std::uint32_t> serial_b(k_NumItems);
+
+  const double serial_ms = TimeMs([&]() {
+    serial_a = items;
+
+    for (std::size_t width = k_RunSize; width < k_NumItems; width *= 2u)
+    {
+      for (std::size_t start = 0u; start < k_NumItems; start += width * 2u)
+      {
+        std::merge(serial_a.begin() + start, serial_a.begin() + start + width, serial_a.begin() + start + width, serial_a.begin() + start + width * 2u, serial_b.begin() + start);
+      }
+
+      serial_a.swap(serial_b);
+    }
+  });
+
+  std::printf("Merge of %zu runs of %zu uint32s, pairwise std::merge: %.2fms\n", k_NumRuns, k_RunSize, serial_ms);
+  std::printf("  %8s %10s %8s %8s\n", "threads", "ms", "speedup", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double merge_ms = TimeMs([&]() { Job::ParallelMergeRuns(runs.data(), runs.size(), merged.data()); });
+
+    std::printf("  %8zu %10.2f %7.2fx %8s\n", num_threads, merge_ms, serial_ms / merge_ms, merged == serial_a ? "yes" : "NO");
+  });
+}
+
+static void BenchHashMap(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumKeys   = std::size_t(1) << 22;
+  static constexpr std::size_t k_GrainSize = 4096u;
+  static constexpr std::size_t k_NumChunks = k_NumKeys / k_GrainSize;
+
+  static_assert(k_NumKeys % k_GrainSize == 0u, "Lookups are split into whole chunks.");
+
+  std::vector<std::uint64_t> keys(k_NumKeys);
+  std::vector<std::uint64_t> values(k_NumKeys);
+  std::mt19937_64            rng{34u};
+
+  for (std::size_t i = 0u; i < k_NumKeys; ++i)
+  {
+    keys[i]   = rng();
+    values[i] = i;
+  }
+
+  std::printf("Hash map of %zu uint64 keys, ms (best of 3)\n", k_NumKeys);
+  std::printf("  %8s %12s %12s %12s %12s %12s\n", "threads", "mutex ins", "mutex find", "insert", "find", "bulk ins");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    std::unordered_map<std::uint64_t, std::uint64_t> locked_map;
+    std::mutex                                       locked_map_lock;
+    std::atomic<std::uint64_t>                       checksum{0u};
+
+    const double mutex_insert_ms = TimeMs([&]() {
+      locked_map.clear();
+      locked_map.reserve(k_NumKeys);
+      Job::TaskSubmitAndWait(Job::ParallelFor(
+       std::size_t(0u), k_NumKeys, Job::Splitter::MaxItemsPerTask(k_GrainSize), [&](Job::Task* const, const std::size_t i) {
+         const std::lock_guard<std::mutex> guard(locked_map_lock);
+         locked_map.emplace(keys[i], values[i]);
+       }));
+    });
+
+    // Lookups sum into a per-task total so the shared `checksum` is only touched once per task.
+    const double mutex_find_ms = TimeMs([&]() {
+      Job::TaskSubmitAndWait(Job::ParallelFor(
+       std::size_t(0u), k_NumChunks, Job::Splitter::MaxItemsPerTask(1u), [&](Job::Task* const, const std::size_t chunk) {
+         std::uint64_t partial_sum = 0u;
+
+         for (std::size_t i = chunk * k_GrainSize; i < (chunk + 1u) * k_GrainSize; ++i)
+         {
+           const std::lock_guard<std::mutex> guard(locked_map_lock);
+           partial_sum += locked_map.find(keys[i])->second;
+         }
+
+         checksum.fetch_add(partial_sum, std::memory_order_relaxed);
+       }));
+    });
+
+    std::unique_ptr<Job::ConcurrentHashMap<std::uint64_t, std::uint64_t>> map;
+
+    const double insert_ms = TimeMs([&]() {
+      map = std::make_unique<Job::ConcurrentHashMap<std::uint64_t, std::uint64_t>>(k_NumKeys);
+      Job::TaskSubmitAndWait(Job::ParallelFor(
+       std::size_t(0u), k_NumKeys, Job::Splitter::MaxItemsPerTask(k_GrainSize), [&](Job::Task* const, const std::size_t i) {
+         map->Insert(keys[i], values[i]);
+       }));
+    });
+
+    const double find_ms = TimeMs([&]() {
+      Job::TaskSubmitAndWait(Job::ParallelFor(
+       std::size_t(0u), k_NumChunks, Job::Splitter::MaxItemsPerTask(1u), [&](Job::Task* const, const std::size_t chunk) {
+         std::uint64_t partial_sum = 0u;
+
+         for (std::size_t i = chunk * k_GrainSize; i < (chunk + 1u) * k_GrainSize; ++i)
+         {
+           partial_sum += *map->Find(keys[i]);
+         }
+
+         checksum.fetch_add(partial_sum, std::memory_order_relaxed);
+       }));
+    });
+
+    const double bulk_insert_ms = TimeMs([&]() {
+      map = std::make_unique<Job::ConcurrentHashMap<std::uint64_t, std::uint64_t>>(k_NumKeys);
+      map->BulkInsert(keys.data(), values.data(), k_NumKeys);
+    });
+
+    std::printf("  %8zu %12.2f %12.2f %12.2f %12.2f %12.2f\n", num_threads, mutex_insert_ms, mutex_find_ms, insert_ms, find_ms, bulk_insert_ms);
+  });
+}
+
+static void BenchSelect(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumElements = std::size_t(1) << 25;
+  static constexpr std::size_t k_TopK        = 1000u;
+
+  std::vector<float> data(k_NumElements);
+  std::vector<float> work(k_NumElements);
+  std::vector<float> top(k_TopK);
+  std::mt19937_64    rng{55u};
+
+  for (float& value : data)
+  {
+    value = float(rng() >> 40);
+  }
+
+  const double serial_top_ms = TimeMs([&]() {
+    std::partial_sort_copy(data.begin(), data.end(), top.begin(), top.end(), std::greater<>{});
+  });
+
+  const double serial_nth_ms = TimeMs([&]() {
+    work = data;
+    std::nth_element(work.begin(), work.begin() + k_NumElements / 3u, work.end());
+  });
+
+  const float expected_top = top.back();
+  const float expected_nth = work[k_NumElements / 3u];
+
+  std::printf("Select from %zu floats, partial_sort_copy top %zu: %.2fms, nth_element (incl. copy): %.2fms\n", k_NumElements, k_TopK, serial_top_ms, serial_nth_ms);
+  std::printf("  %8s %10s %8s %10s %8s %8s\n", "threads", "top ms", "speedup", "nth ms", "speedup", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double top_ms = TimeMs([&]() { Job::ParallelTopK(data.data(), k_NumElements, k_TopK, std::greater<>{}, top.data()); });
+    const double nth_ms = TimeMs([&]() {
+      work = data;
+      Job::ParallelNthElement(work.begin(), work.begin() + k_NumElements / 3u, work.end());
+    });
+
+    const bool matches = top.back() == expected_top && work[k_NumElements / 3u] == expected_nth;
+
+    std::printf("  %8zu %10.2f %7.2fx %10.2f %7.2fx %8s\n", num_threads, top_ms, serial_top_ms / top_ms, nth_ms, serial_nth_ms / nth_ms, matches ? "yes" : "NO");
+  });
+}
+
+static void BenchNumeric(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumElements = std::size_t(1) << 26;
+  static constexpr double      k_NumGB       = double(k_NumElements * sizeof(float)) / 1e9;
+
+  std::vector<float> data(k_NumElements);
+  std::mt19937_64    rng{89u};
+
+  for (float& value : data)
+  {
+    value = float(rng() >> 44) * 0.001f;
+  }
+
+  double      serial_sum   = 0.0;
+  float       serial_min   = data[0];
+  float       serial_max   = data[0];
+  std::size_t serial_index = 0u;
+
+  const double serial_sum_ms = TimeMs([&]() {
+    serial_sum = 0.0;
+
+    for (const float value : data)
+    {
+      serial_sum += value;
+    }
+  });
+
+  const double serial_min_max_ms = TimeMs([&]() {
+    const auto result = std::minmax_element(data.begin(), data.end());
+    serial_min        = *result.first;
+    serial_max        = *result.second;
+    serial_index      = std::size_t(result.first - data.begin());
+  });
+
+  const char* const simd_names[] = {"scalar", "SSE2", "AVX2", "NEON"};
+
+  std::printf("Reduce %zu floats (%s), serial sum: %.2fms, std::minmax_element: %.2fms\n", k_NumElements, simd_names[int(Job::NumericSimdLevel())], serial_sum_ms, serial_min_max_ms);
+  std::printf("  %8s %10s %8s %10s %8s %10s %8s %8s\n", "threads", "sum ms", "GB/s", "minmax ms", "GB/s", "argmin ms", "GB/s", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    double            sum     = 0.0;
+    Job::MinMaxResult min_max = {};
+    Job::ArgMinResult arg_min = {};
+
+    const double sum_ms     = TimeMs([&]() { sum = Job::ParallelSum(data.data(), k_NumElements); });
+    const double min_max_ms = TimeMs([&]() { min_max = Job::ParallelMinMax(data.data(), k_NumElements); });
+    const double arg_min_ms = TimeMs([&]() { arg_min = Job::ParallelArgMin(data.data(), k_NumElements); });
+
+    const bool matches = std::abs(sum - serial_sum) <= 1e-5 * std::abs(serial_sum) && min_max.min == serial_min && min_max.max == serial_max && arg_min.index == serial_index;
+
+    std::printf("  %8zu %10.2f %8.2f %10.2f %8.2f %10.2f %8.2f %8s\n", num_threads, sum_ms, k_NumGB / (sum_ms / 1000.0), min_max_ms, k_NumGB / (min_max_ms / 1000.0), arg_min_ms, k_NumGB / (arg_min_ms / 1000.0), matches ? "yes" : "NO");
+  });
+}
+
+static void BenchSoA(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumElements = std::size_t(1) << 22;
+  static constexpr std::size_t k_NumSteps    = 8u;
+  static constexpr float       k_DeltaTime   = 1.0f / 60.0f;
+
+  // Cold data the update never reads but AoS iteration still streams through the cache.
+  struct ParticleCold
+  {
+    float         color[4];
+    std::uint32_t id;
+    std::uint32_t flags;
+    float         lifetime;
+    float         padding;
+  };
+
+  struct ParticleAoS
+  {
+    float        px, py, pz;
+    float        vx, vy, vz;
+    ParticleCold cold;
+  };
+
+  using SoAContainer = Job::ChunkedSoA<float, float, float, float, float, float, ParticleCold>;
+
+  std::vector<ParticleAoS> aos(k_NumElements);
+  std::mt19937_64          rng{377u};
+
+  for (ParticleAoS& particle : aos)
+  {
+    particle    = ParticleAoS{};
+    particle.vx = float(rng() >> 44) * 0.001f;
+    particle.vy = float(rng() >> 44) * 0.001f;
+    particle.vz = float(rng() >> 44) * 0.001f;
+  }
+
+  SoAContainer soa;
+
+  for (const ParticleAoS& particle : aos)
+  {
+    soa.PushBack(particle.px, particle.py, particle.pz, particle.vx, particle.vy, particle.vz, particle.cold);
+  }
+
+  std::printf("Integrate %zu particles x %zu steps, AoS %zu bytes per particle, SoA %zu per chunk\n", k_NumElements, k_NumSteps, sizeof(ParticleAoS), SoAContainer::k_ElementsPerChunk);
+  std::printf("  %8s %12s %12s %8s %8s\n", "threads", "AoS ms", "SoA ms", "ratio", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double aos_ms = TimeMs([&]() {
+      for (std::size_t step = 0u; step < k_NumSteps; ++step)
+      {
+        Job::TaskSubmitAndWait(Job::ParallelFor(aos.data(), k_NumElements, Job::Splitter::MaxItemsPerTask(SoAContainer::k_ElementsPerChunk), [](Job::Task* const, ParticleAoS* const particle) {
+          particle->px += particle->vx * k_DeltaTime;
+          particle->py += particle->vy * k_DeltaTime;
+          particle->pz += particle->vz * k_DeltaTime;
+        }));
+      }
+    });
+
+    const double soa_ms = TimeMs([&]() {
+      for (std::size_t step = 0u; step < k_NumSteps; ++step)
+      {
+        Job::TaskSubmitAndWait(Job::ParallelForEachChunk(soa, [](Job::Task* const, const SoAContainer::ChunkView& chunk) {
+          float* const       px    = chunk.Get<0>();
+          float* const       py    = chunk.Get<1>();
+          float* const       pz    = chunk.Get<2>();
+          const float* const vx    = chunk.Get<3>();
+          const float* const vy    = chunk.Get<4>();
+          const float* const vz    = chunk.Get<5>();
+          const std::size_t  count = chunk.count;
+
+          for (std::size_t i = 0u; i < count; ++i)
+          {
+            px[i] += vx[i] * k_DeltaTime;
+            py[i] += vy[i] * k_DeltaTime;
+            pz[i] += vz[i] * k_DeltaTime;
+          }
+        }));
+      }
+    });
+
+    bool matches = true;
+    for (std::size_t i = 0u; i < k_NumElements; i += 4099u)
+    {
+      matches = matches && aos[i].px == soa.Get<0>(i) && aos[i].pz == soa.Get<2>(i);
+    }
+
+    std::printf("  %8zu %12.2f %12.2f %8.2f %8s\n", num_threads, aos_ms, soa_ms, aos_ms / soa_ms, matches ? "yes" : "NO");
+  });
+}
+
+static void BenchDataFlow(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumTasks     = 10000u;
+  static constexpr std::size_t k_NumResources = 256u;
+  static constexpr std::size_t k_NumFrames    = 10u;
+  static constexpr int         k_TaskWork     = 200;
+
+  struct Step
+  {
+    std::uint32_t reads[2];
+    std::uint32_t write;
+  };
+
+  std::vector<Step>          steps(k_NumTasks);
+  std::vector<std::uint64_t> resources(k_NumResources);
+  std::mt19937_64            rng{610u};
+
+  for (Step& step : steps)
+  {
+    step.reads[0] = std::uint32_t(rng() % k_NumResources);
+    step.reads[1] = std::uint32_t(rng() % k_NumResources);
+    step.write    = std::uint32_t(rng() % k_NumResources);
+  }
+
+  // A little work per task so the graph has something to overlap.
+  const auto Work = [](std::uint64_t seed) {
+    for (int i = 0; i < k_TaskWork; ++i)
+    {
+      seed = seed * 6364136223846793005u + 1442695040888963407u;
+    }
+    return seed;
+  };
+
+  std::printf("%zu tasks per frame over %zu resources, %zu frames\n", k_NumTasks, k_NumResources, k_NumFrames);
+  std::printf("  %8s %14s %14s %14s\n", "threads", "independent ms", "data-flow ms", "submit us/task");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    // Baseline: the same tasks with no dependencies at all.
+    const double independent_ms = TimeMs([&]() {
+      for (std::size_t frame = 0u; frame < k_NumFrames; ++frame)
+      {
+        Job::TaskSubmitAndWait(Job::ParallelFor(std::size_t(0u), k_NumTasks, Job::Splitter::MaxItemsPerTask(1u), [&resources, &steps, Work](Job::Task* const, const std::size_t index) {
+          volatile std::uint64_t sink = Work(resources[steps[index].reads[0]] + index);
+          (void)sink;
+        }));
+      }
+    });
+
+    Job::DataFlow flow;
+    double        submit_ms = 0.0;
+
+    const double data_flow_ms = TimeMs([&]() {
+      submit_ms = 0.0;
+
+      for (std::size_t frame = 0u; frame < k_NumFrames; ++frame)
+      {
+        const BenchClock::time_point start = BenchClock::now();
+
+        for (std::size_t i = 0u; i < k_NumTasks; ++i)
+        {
+          const Step& step = steps[i];
+
+          flow.Submit(Job::Reads(resources[step.reads[0]], resources[step.reads[1]]), Job::Writes(resources[step.write]), [&resources, &step, i, Work](Job::Task* const) {
+            resources[step.write] = Work(resources[step.reads[0]] ^ resources[step.reads[1]] ^ i);
+          });
+        }
+
+        submit_ms += std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+        flow.Wait();
+      }
+    });
+
+    std::printf("  %8zu %14.2f %14.2f %14.3f\n", num_threads, independent_ms, data_flow_ms, submit_ms * 1000.0 / double(k_NumTasks * k_NumFrames));
+  });
+}
+
+static void BenchReplay(const BenchOptions& options)
+{
+  static constexpr int         k_NumSystems        = 32;
+  static constexpr int         k_NumTasksPerSystem = 24;
+  static constexpr std::size_t k_NumFrames         = 200u;
+
+  std::vector<std::uint64_t> outputs(std::size_t(k_NumSystems * k_NumTasksPerSystem));
+
+  // The same frame every time: a root per system, leaf tasks under it and a continuation that folds them.
+  const auto IssueFrame = [&outputs]() {
+    Job::Task* const frame = Job::TaskMake([](Job::Task* const) {});
+
+    for (int system = 0; system < k_NumSystems; ++system)
+    {
+      Job::Task* const root = Job::TaskMake([](Job::Task* const) {}, frame);
+
+      for (int i = 0; i < k_NumTasksPerSystem; ++i)
+      {
+        std::uint64_t* const output = &outputs[std::size_t(system * k_NumTasksPerSystem + i)];
+
+        Job::TaskSubmit(Job::TaskMake([output](Job::Task* const) { *output = *output * 6364136223846793005u + 1u; }, root));
+      }
+
+      Job::Task* const fold = Job::TaskMake(
+       [&outputs, system](Job::Task* const) {
+         std::uint64_t sum = 0u;
+
+         for (int i = 0; i < k_NumTasksPerSystem; ++i)
+         {
+           sum += outputs[std::size_t(system * k_NumTasksPerSystem + i)];
+         }
+
+         outputs[std::size_t(system * k_NumTasksPerSystem)] ^= sum;
+       },
+       frame);
+
+      Job::TaskAddContinuation(root, fold);
+      Job::TaskSubmit(root);
+    }
+
+    return frame;
+  };
+
+  std::printf("%d systems x %d tasks + continuations per frame, %zu frames\n", k_NumSystems, k_NumTasksPerSystem, k_NumFrames);
+  std::printf("  %8s %14s %14s %10s\n", "threads", "dynamic us/f", "replay us/f", "speedup");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    const double dynamic_ms = TimeMs([&]() {
+      for (std::size_t frame = 0u; frame < k_NumFrames; ++frame)
+      {
+        Job::TaskSubmitAndWait(IssueFrame());
+      }
+    });
+
+    Job::BeginRecord();
+    Job::TaskSubmit(IssueFrame());
+    Job::TaskGraph* const graph = Job::EndRecord();
+
+    const double replay_ms = TimeMs([&]() {
+      for (std::size_t frame = 0u; frame < k_NumFrames; ++frame)
+      {
+        Job::Replay(graph);
+      }
+    });
+
+    Job::TaskGraphDestroy(graph);
+
+    std::printf("  %8zu %14.2f %14.2f %10.2f\n", num_threads, dynamic_ms * 1000.0 / double(k_NumFrames), replay_ms * 1000.0 / double(k_NumFrames), dynamic_ms / replay_ms);
+  });
+}
+
+static void BenchCriticalPath(const BenchOptions& options)
+{
+  static constexpr std::size_t   k_NumLayers   = 32u;
+  static constexpr std::size_t   k_LayerWidth  = 64u;
+  static constexpr std::uint32_t k_CheapCostUs = 10u;
+  static constexpr std::uint32_t k_HeavyCostUs = 100u;
+
+  // Layered out-forest: every task in layer `i + 1` is a continuation of a random task in layer `i`,
+  // one heavy task per layer forms a chain through the whole graph.
+  std::vector<std::uint32_t> predecessors(k_NumLayers * k_LayerWidth);
+  std::vector<std::uint32_t> costs_us(k_NumLayers * k_LayerWidth, k_CheapCostUs);
+  std::mt19937_64            rng{72u};
+  std::size_t                heavy_index = rng() % k_LayerWidth;
+
+  costs_us[heavy_index] = k_HeavyCostUs;
+
+  for (std::size_t layer = 1u; layer < k_NumLayers; ++layer)
+  {
+    const std::size_t next_heavy_index = layer * k_LayerWidth + rng() % k_LayerWidth;
+
+    for (std::size_t i = layer * k_LayerWidth; i < (layer + 1u) * k_LayerWidth; ++i)
+    {
+      predecessors[i] = std::uint32_t((layer - 1u) * k_LayerWidth + rng() % k_LayerWidth);
+    }
+
+    predecessors[next_heavy_index] = std::uint32_t(heavy_index);
+    costs_us[next_heavy_index]     = k_HeavyCostUs;
+    heavy_index                    = next_heavy_index;
+  }
+
+  const double total_us = std::accumulate(costs_us.begin(), costs_us.end(), 0.0);
+  const double chain_us = double(k_NumLayers * k_HeavyCostUs);
+
+  const auto Record = [&](const bool with_hints) {
+    std::vector<Job::Task*> tasks(costs_us.size());
+
+    Job::BeginRecord(std::uint16_t(costs_us.size()));
+
+    for (std::size_t i = 0u; i < costs_us.size(); ++i)
+    {
+      const std::uint32_t cost_us = costs_us[i];
+
+      tasks[i] = Job::TaskMake([cost_us](Job::Task* const) {
+        const BenchClock::time_point end = BenchClock::now() + std::chrono::microseconds(cost_us);
+
+        while (BenchClock::now() < end)
+        {
+        }
+      });
+
+      if (with_hints)
+      {
+        Job::TaskSetCostHint(tasks[i], float(cost_us));
+      }
+    }
+
+    // A task must have all of its continuations before being made a continuation itself.
+    for (std::size_t i = costs_us.size(); i-- > k_LayerWidth;)
+    {
+      Job::TaskAddContinuation(tasks[predecessors[i]], tasks[i]);
+    }
+
+    for (std::size_t i = 0u; i < k_LayerWidth; ++i)
+    {
+      Job::TaskSubmit(tasks[i]);
+    }
+
+    return Job::EndRecord();
+  };
+
+  std::printf("Layered DAG: %zu layers x %zu tasks (%uus), one %uus task per layer chained, total work %.1fms, critical path %.1fms\n", k_NumLayers, k_LayerWidth, k_CheapCostUs, k_HeavyCostUs, total_us / 1000.0, chain_us / 1000.0);
+  std::printf("  %8s %12s %12s %12s %12s %10s\n", "threads", "submit ms", "cp hint ms", "cp meas. ms", "bound ms", "reduction");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    Job::TaskGraph* const submission_graph = Record(false);
+    Job::TaskGraph* const hinted_graph     = Record(true);
+    Job::TaskGraph* const measured_graph   = Record(false);
+
+    Job::TaskGraphSetSchedule(hinted_graph, Job::TaskGraphSchedule::CRITICAL_PATH);
+    Job::TaskGraphSetSchedule(measured_graph, Job::TaskGraphSchedule::CRITICAL_PATH);
+
+    // One run so the measured costs are in place.
+    Job::Replay(measured_graph);
+
+    const double submission_ms = TimeMs([&]() { Job::Replay(submission_graph); });
+    const double hinted_ms     = TimeMs([&]() { Job::Replay(hinted_graph); });
+    const double measured_ms   = TimeMs([&]() { Job::Replay(measured_graph); });
+    const double bound_ms      = std::max(chain_us, total_us / double(num_threads)) / 1000.0;
+
+    Job::TaskGraphDestroy(submission_graph);
+    Job::TaskGraphDestroy(hinted_graph);
+    Job::TaskGraphDestroy(measured_graph);
+
+    std::printf("  %8zu %12.2f %12.2f %12.2f %12.2f %9.1f%%\n", num_threads, submission_ms, hinted_ms, measured_ms, bound_ms, 100.0 * (1.0 - std::min(hinted_ms, measured_ms) / submission_ms));
+  });
+}
+
+static std::uint64_t BenchFork2Fib(const int n)
+{
+  if (n < 2)
+  {
+    return std::uint64_t(n);
+  }
+
+  std::uint64_t a, b;
+  Job::Fork2([&a, n]() { a = BenchFork2Fib(n - 1); }, [&b, n]() { b = BenchFork2Fib(n - 2); });
+
+  return a + b;
+}
+
+static std::uint64_t BenchHeartbeatFib(const int n)
+{
+  if (n < 2)
+  {
+    return std::uint64_t(n);
+  }
+
+  std::uint64_t a, b;
+  Job::HeartbeatFork2([&a, n]() { a = BenchHeartbeatFib(n - 1); }, [&b, n]() { b = BenchHeartbeatFib(n - 2); });
+
+  return a + b;
+}
+
+static void BenchHeartbeat(const BenchOptions& options)
+{
+  static constexpr int         k_FibN      = 30;
+  static constexpr std::size_t k_NumItems  = std::size_t(1) << 24;
+  static constexpr std::size_t k_GrainSize = 256u;
+
+  // Every call with `n >= 2` forks, no cutoff so each fork only guards a few nanoseconds of work.
+  const double num_forks = double(SerialFib(k_FibN + 1) - 1u);
+
+  std::vector<float> data(k_NumItems, 1.0f);
+
+  const auto LoopBody = [&data](const std::size_t index) { data[index] = data[index] * 0.5f + 1.0f; };
+
+  const double fib_serial_ms  = TimeMs([]() { SerialFib(k_FibN); });
+  const double loop_serial_ms = TimeMs([&]() {
+    for (std::size_t i = 0u; i < k_NumItems; ++i)
+    {
+      LoopBody(i);
+    }
+  });
+
+  std::printf("fib(%i) without cutoff (%.0f forks) serial: %.2fms, loop over %zu floats serial: %.2fms\n", k_FibN, num_forks, fib_serial_ms, k_NumItems, loop_serial_ms);
+
+  for (const std::uint32_t heartbeat_us : {100u, 0u})
+  {
+    Job::JobSystemCreateOptions create_options = {};
+    create_options.heartbeat_us                = heartbeat_us;
+
+    std::printf("  heartbeat %uus%s\n", heartbeat_us, heartbeat_us == 0u ? " (every latent fork promoted)" : "");
+    std::printf("  %8s %10s %12s %10s %12s %12s %12s\n", "threads", "Fork2 ms", "ns / fork", "latent ms", "ns / fork", "pfor(256) ms", "latent ms");
+
+    ForEachThreadCount(
+     options, [&](const std::size_t num_threads) {
+       const double fork2_ms     = TimeMs([]() { BenchFork2Fib(k_FibN); });
+       const double heartbeat_ms = TimeMs([]() { BenchHeartbeatFib(k_FibN); });
+       const double pfor_ms      = TimeMs([&]() {
+         Job::TaskSubmitAndWait(Job::ParallelFor(std::size_t(0u), k_NumItems, Job::Splitter::MaxItemsPerTask(k_GrainSize), [&LoopBody](Job::Task* const, const std::size_t index) { LoopBody(index); }));
+       });
+       const double latent_loop_ms = TimeMs([&]() { Job::HeartbeatParallelFor(0u, k_NumItems, LoopBody); });
+
+       std::printf("  %8zu %10.2f %12.1f %10.2f %12.1f %12.2f %12.2f\n", num_threads, fork2_ms, (fork2_ms - fib_serial_ms) * 1e6 / num_forks, heartbeat_ms, (heartbeat_ms - fib_serial_ms) * 1e6 / num_forks, pfor_ms, latent_loop_ms);
+     },
+     create_options);
+  }
+}
+
+struct BenchStealProbe
+{
+  std::int64_t               submit_ns;
+  std::atomic<std::int64_t>  start_ns;
+  std::atomic<Job::WorkerID> runner;
+  Job::WorkerID              submitter;
+};
+
+static std::int64_t BenchNowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now().time_since_epoch()).count();
+}
+
+// Owner push then pop on an uncontended deque, so only the cost of the pop's fence differs.
+static double BenchDequeOwnerNs(const bool asymmetric_fence)
+{
+  static constexpr std::size_t  k_NumOps   = std::size_t(1) << 22;
+  static constexpr std::int64_t k_Capacity = 64;
+
+  std::vector<std::atomic<std::size_t>> backing_storage(k_Capacity);
+  Job::SPMCDeque<std::size_t>           deque{};
+  std::size_t                           sum = 0u;
+
+  deque.Initialize(backing_storage.data(), k_Capacity, asymmetric_fence);
+
+  const double ms = TimeMs([&]() {
+    for (std::size_t i = 0u; i < k_NumOps; ++i)
+    {
+      std::size_t value;
+
+      deque.Push(i);
+      deque.Pop(&value);
+      sum += value;
+    }
+  });
+
+  volatile std::size_t sink = sum;
+  (void)sink;
+
+  return ms * 1e6 / double(k_NumOps);
+}
+
+static void BenchWorkStealing(const BenchOptions& options)
+{
+  static constexpr int          k_FibN         = 25;
+  static constexpr std::size_t  k_NumItems     = std::size_t(1) << 18;
+  static constexpr std::size_t  k_NumProbes    = 512u;
+  static constexpr std::size_t  k_NumFillers   = 8u;
+  static constexpr std::int64_t k_FillerSpinNs = 2000;
+
+  const double num_forks = double(SerialFib(k_FibN + 1) - 1u);
+
+  std::vector<BenchStealProbe> probes(k_NumProbes);
+
+  static const char* const k_WorkStealingNames[] = {"shared", "private", "asym"};
+
+  const auto SubmitProbes = [](BenchStealProbe* const probes_data) {
+    for (std::size_t i = 0u; i < k_NumProbes; ++i)
+    {
+      BenchStealProbe* const probe = probes_data + i;
+      Job::Task* const       group = Job::TaskMake([](Job::Task* const) {});
+
+      probe->submitter = Job::CurrentWorker();
+      probe->submit_ns = BenchNowNs();
+
+      // Pushed first so it is the oldest task, the one thieves are given.
+      Job::TaskSubmit(Job::TaskMake([probe](Job::Task* const) {
+        probe->start_ns.store(BenchNowNs(), std::memory_order_relaxed);
+        probe->runner.store(Job::CurrentWorker(), std::memory_order_relaxed);
+      },
+                                    group));
+
+      for (std::size_t j = 0u; j < k_NumFillers; ++j)
+      {
+        Job::TaskSubmit(Job::TaskMake([](Job::Task* const) {
+          const std::int64_t end = BenchNowNs() + k_FillerSpinNs;
+
+          while (BenchNowNs() < end)
+          {
+          }
+        },
+                                      group));
+      }
+
+      Job::TaskSubmitAndWait(group);
+    }
+  };
+
+  std::printf("Per task overhead: fib(%i) with Fork2 and no cutoff (%.0f forks), ParallelFor of %zu single item tasks.\n", k_FibN, num_forks, k_NumItems);
+  std::printf("Steal latency: a worker submits a probe then %zu x %lldus tasks, time from the submit to a thief starting the probe.\n", k_NumFillers, (long long)(k_FillerSpinNs / 1000));
+  std::printf("Owner push + pop on an SPMCDeque: %.1f ns with a full fence, %.1f ns with a compiler barrier.\n", BenchDequeOwnerNs(false), BenchDequeOwnerNs(true));
+  std::printf("  %8s %8s %10s %10s %14s %8s\n", "threads", "deques", "ns / fork", "ns / task", "steal p50 us", "stolen");
+
+  for (const Job::WorkStealing work_stealing : {Job::WorkStealing::SHARED_DEQUES, Job::WorkStealing::PRIVATE_DEQUES, Job::WorkStealing::ASYMMETRIC_FENCES})
+  {
+    Job::JobSystemCreateOptions create_options = {};
+    create_options.work_stealing               = work_stealing;
+
+    ForEachThreadCount(
+     options, [&](const std::size_t num_threads) {
+       const double fib_ms  = TimeMs([]() { BenchFork2Fib(k_FibN); });
+       const double pfor_ms = TimeMs([]() {
+         Job::TaskSubmitAndWait(Job::ParallelFor(std::size_t(0u), k_NumItems, Job::Splitter::MaxItemsPerTask(1u), [](Job::Task* const, const std::size_t) {}));
+       });
+
+       BenchStealProbe* const probes_data = probes.data();
+
+       // The worker queue keeps the probes off of the main thread, which always uses a shared deque.
+       Job::TaskSubmitAndWait(Job::TaskMake([probes_data, &SubmitProbes](Job::Task* const) { SubmitProbes(probes_data); }), Job::QueueType::WORKER);
+
+       std::vector<double> steal_latencies_us;
+
+       for (const BenchStealProbe& probe : probes)
+       {
+         if (probe.runner.load() != probe.submitter)
+         {
+           steal_latencies_us.push_back(double(probe.start_ns.load() - probe.submit_ns) / 1000.0);
+         }
+       }
+
+       double steal_p50_us = 0.0;
+
+       if (!steal_latencies_us.empty())
+       {
+         std::nth_element(steal_latencies_us.begin(), steal_latencies_us.begin() + steal_latencies_us.size() / 2u, steal_latencies_us.end());
+         steal_p50_us = steal_latencies_us[steal_latencies_us.size() / 2u];
+       }
+
+       std::printf("  %8zu %8s %10.1f %10.1f %14.1f %7.0f%%\n", num_threads, k_WorkStealingNames[int(work_stealing)], fib_ms * 1e6 / num_forks, pfor_ms * 1e6 / double(k_NumItems), steal_p50_us, 100.0 * double(steal_latencies_us.size()) / double(k_NumProbes));
+     },
+     create_options);
+  }
+}
+
+static void BenchStdPar(const BenchOptions& options)
+{
+  static constexpr std::size_t k_NumElements = std::size_t(1) << 24;
+
+  std::vector<double> source(k_NumElements);
+  std::vector<double> work(k_NumElements);
+  std::mt19937_64     rng{144u};
+
+  for (double& value : source)
+  {
+    value = double(rng() >> 11) * 0x1.0p-53;
+  }
+
+  const auto Transform = [](const double value) { return std::sqrt(value) * 3.0 + 1.0; };
+
+  double serial_sum = 0.0;
+
+  const double serial_transform_ms = TimeMs([&]() { std::transform(source.begin(), source.end(), work.begin(), Transform); });
+  const double serial_reduce_ms    = TimeMs([&]() { serial_sum = std::reduce(source.begin(), source.end()); });
+  const double serial_sort_ms      = TimeMs([&]() { work = source; std::sort(work.begin(), work.end()); });
+
+  std::printf("std_par on %zu doubles, std:: transform %.2fms, reduce %.2fms, sort (incl. copy) %.2fms\n", k_NumElements, serial_transform_ms, serial_reduce_ms, serial_sort_ms);
+  std::printf("  %8s %12s %8s %12s %8s %12s %8s %8s\n", "threads", "transform", "speedup", "reduce", "speedup", "sort", "speedup", "matches");
+
+  ForEachThreadCount(options, [&](const std::size_t num_threads) {
+    double sum = 0.0;
+
+    const double transform_ms = TimeMs([&]() { Job::std_par::transform(Job::execution::par, source.begin(), source.end(), work.begin(), Transform); });
+    const double reduce_ms    = TimeMs([&]() { sum = Job::std_par::reduce(Job::execution::par, source.begin(), source.end()); });
+    const double sort_ms      = TimeMs([&]() { work = source; Job::std_par::sort(Job::execution::par, work.begin(), work.end()); });
+
+    const bool matches = std::is_sorted(work.begin(), work.end()) && std::abs(sum - serial_sum) <= 1e-9 * serial_sum;
+
+    std::printf("  %8zu %12.2f %7.2fx %12.2f %7.2fx %12.2f %7.2fx %8s\n", num_threads, transform_ms, serial_transform_ms / transform_ms, reduce_ms, serial_reduce_ms / reduce_ms, sort_ms, serial_sort_ms / sort_ms, matches ? "yes" : "NO");
+  });
+}
+
+struct BenchmarkEntry
+{
+  const char* name;
+  void (*fn)(const BenchOptions& options);
+};
+
+static const BenchmarkEntry k_Benchmarks[] = {
+ {"shuffle", &BenchShuffle},
+ {"recurse", &BenchRecurse},
+ {"bfs", &BenchBFS},
+ {"bytes", &BenchBytes},
+ {"crc32c", &BenchCrc32c},
+ {"merge", &BenchMerge},
+ {"hashmap", &BenchHashMap},
+ {"select", &BenchSelect},
+ {"numeric", &BenchNumeric},
+ {"stdpar", &BenchStdPar},
+ {"soa", &BenchSoA},
+ {"dataflow", &BenchDataFlow},
+ {"replay", &BenchReplay},
+ {"critpath", &BenchCriticalPath},
+ {"heartbeat", &BenchHeartbeat},
+ {"stealing", &BenchWorkStealing},
+ {"lines", &BenchLines},
+};
+
+int main(int argc, char* argv[])
+{
+  const char* const filter      = argc > 1 ? argv[1] : "";
+  const int         max_threads = argc > 2 ? std::atoi(argv[2]) : int(Job::NumSystemThreads());
+
+  BenchOptions options = {};
+  options.max_threads  = std::size_t(max_threads > 0 ? max_threads : 1);
+
+  for (const BenchmarkEntry& benchmark : k_Benchmarks)
+  {
+    if (std::strstr(benchmark.name, filter))
+    {
+      std::printf("== %s ==\n", benchmark.name);
+      benchmark.fn(options);
+      std::printf("\n");
+    }
+  }
+
+  return 0;
+}
@@ -4,12 +4,36 @@
 //
 // Contains Unit Test for the Job System.
 //
+#include "concurrent/job_algorithms.hpp"
+#include "concurrent/job_bytes.hpp"
+#include "concurrent/job_chunked_soa.hpp"
+#include "concurrent/job_data_flow.hpp"
+#include "concurrent/job_execution.hpp"
+#include "concurrent/job_file.hpp"
+#include "concurrent/job_graph.hpp"
+#include "concurrent/job_hash_map.hpp"
+#include "concurrent/job_numeric.hpp"
 #include "concurrent/job_queue.hpp"
+#include "concurrent/job_random.hpp"
+#include "concurrent/job_worker_local.hpp"
 
 #include <gtest/gtest.h>
 
-#include <memory>   // unique_ptr
-#include <numeric>  // iota
+#include <algorithm>   // count, sort, partition, partial_sort, all_of, stable_sort, is_sorted, transform
+#include <array>       // array
+#include <atomic>      // atomic
+#include <cstdio>      // fopen, fwrite, remove
+#include <cstring>     // memcmp
+#include <functional>  // greater
+#include <limits>      // numeric_limits
+#include <list>        // list
+#include <map>         // map
+#include <memory>      // unique_ptr
+#include <numeric>     // iota, partial_sum, accumulate
+#include <string>      // string
+#include <thread>      // this_thread, thread::id
+#include <utility>     // pair
+#include <vector>      // vector
 
 struct IndexIterator
 {
@@ -188,6 +212,25 @@ TEST(JobSystemTests, BasicParallelInvoke)
   }
 }
 
+static std::uint64_t Fork2Fibonacci(const std::uint64_t n)
+{
+  if (n < 12u)
+  {
+    return n < 2u ? n : Fork2Fibonacci(n - 1u) + Fork2Fibonacci(n - 2u);
+  }
+
+  std::uint64_t a, b;
+  Job::Fork2([&a, n]() { a = Fork2Fibonacci(n - 1u); }, [&b, n]() { b = Fork2Fibonacci(n - 2u); });
+
+  return a + b;
+}
+
+// Tests recursive `Fork2` producing the correct result.
+TEST(JobSystemTests, Fork2Recursive)
+{
+  EXPECT_EQ(Fork2Fibonacci(24u), 46368u);
+}
+
 // Tests keeping task alive through reference count API
 TEST(JobSystemTests, GCReferenceCount)
 {
@@ -287,6 +330,1248 @@ TEST(JobSystemTests, SPSCQueue)
   t1.join();
 }
 
+// Tests `WorkerLocal` accumulating per worker then combining at the end.
+TEST(JobSystemTests, WorkerLocalCombine)
+{
+  static constexpr std::size_t k_DataSize = 100000;
+
+  Job::WorkerLocal<std::size_t> partial_sums{0u};
+
+  Job::Task* const task = Job::ParallelFor(
+   0, k_DataSize, Job::Splitter::MaxItemsPerTask(256), [&partial_sums](Job::Task*, const std::size_t i) {
+     partial_sums.Local() += i;
+   });
+
+  TaskSubmitAndWait(task);
+
+  std::size_t num_constructed = 0u;
+  partial_sums.ForEach([&num_constructed](std::size_t&) { ++num_constructed; });
+
+  EXPECT_GE(num_constructed, 1u);
+  EXPECT_LE(num_constructed, Job::NumWorkers());
+  EXPECT_EQ(partial_sums.Combine([](std::size_t a, std::size_t b) { return a + b; }), (k_DataSize * (k_DataSize - 1)) / 2);
+
+  partial_sums.Clear();
+  EXPECT_EQ(partial_sums.Combine([](std::size_t a, std::size_t b) { return a + b; }), 0u);
+}
+
+// Tests the early exit searches find the correct (lowest) index.
+TEST(JobSystemTests, ParallelSearch)
+{
+  static constexpr int         k_DataSize   = 1000000;
+  const std::unique_ptr<int[]> example_data = AllocateIntArray(k_DataSize);
+
+  std::fill_n(example_data.get(), k_DataSize, 0);
+  example_data[k_DataSize - 10] = 7;
+  example_data[654321]          = 7;
+  example_data[654322]          = 7;
+  example_data[987654]          = 7;
+
+  const auto splitter = Job::Splitter::MaxItemsPerTask(1024);
+  const int* data     = example_data.get();
+
+  EXPECT_EQ(Job::ParallelFindFirst(data, k_DataSize, splitter, 7), 654321u);
+  EXPECT_EQ(Job::ParallelFindFirst(data, k_DataSize, splitter, 8), std::size_t(k_DataSize));
+  EXPECT_EQ(Job::ParallelFindIf(100, k_DataSize - 100, splitter, [data](const std::size_t i) { return data[i] != 0; }), 654321u);
+  EXPECT_EQ(Job::ParallelFindIf(654322, k_DataSize - 654322, splitter, [data](const std::size_t i) { return data[i] != 0; }), 654322u);
+  EXPECT_TRUE(Job::ParallelAnyOf(0, k_DataSize, splitter, [data](const std::size_t i) { return data[i] == 7; }));
+  EXPECT_FALSE(Job::ParallelAnyOf(0, k_DataSize, splitter, [data](const std::size_t i) { return data[i] == 3; }));
+  EXPECT_TRUE(Job::ParallelAllOf(0, 654321, splitter, [data](const std::size_t i) { return data[i] == 0; }));
+  EXPECT_FALSE(Job::ParallelAllOf(0, k_DataSize, splitter, [data](const std::size_t i) { return data[i] == 0; }));
+}
+
+// Tests `ParallelReduceDeterministic` matches a serial evaluation of the same combine tree bit for bit.
+TEST(JobSystemTests, ParallelReduceDeterministic)
+{
+  static constexpr std::size_t k_DataSize  = 1000003;
+  static constexpr std::size_t k_LeafGrain = 1000;
+
+  std::unique_ptr<float[]> example_data{new float[k_DataSize]};
+
+  for (std::size_t i = 0; i < k_DataSize; ++i)
+  {
+    example_data[i] = float(i % 1013) * (i & 1 ? 1.0e-3f : 1.0e3f);
+  }
+
+  const float* data    = example_data.get();
+  const auto   leaf    = [data](const std::size_t bgn, const std::size_t end) {
+    float sum = 0.0f;
+    for (std::size_t i = bgn; i < end; ++i)
+    {
+      sum += data[i];
+    }
+    return sum;
+  };
+  const auto combine = [](const float lhs, const float rhs) { return lhs + rhs; };
+
+  const auto SerialTree = [&](const auto& self, const std::size_t start, const std::size_t count) -> float {
+    if (count <= k_LeafGrain)
+    {
+      return leaf(start, start + count);
+    }
+
+    const std::size_t left_count = count / 2;
+    return combine(self(self, start, left_count), self(self, start + left_count, count - left_count));
+  };
+
+  const float expected = SerialTree(SerialTree, 0u, k_DataSize);
+
+  for (int run = 0; run < 4; ++run)
+  {
+    const float result = Job::ParallelReduceDeterministic(std::size_t(0u), k_DataSize, k_LeafGrain, 0.0f, leaf, combine);
+
+    EXPECT_EQ(std::memcmp(&result, &expected, sizeof(float)), 0) << "Run " << run << " was not bit identical.";
+  }
+}
+
+// Tests `ParallelGenerateRandom` output only depends on the seed.
+TEST(JobSystemTests, ParallelGenerateRandom)
+{
+  static constexpr std::size_t k_DataSize = Job::k_RandomChunkSize * 5 + 123;
+
+  std::unique_ptr<std::uint32_t[]> run_a{new std::uint32_t[k_DataSize]};
+  std::unique_ptr<std::uint32_t[]> run_b{new std::uint32_t[k_DataSize]};
+  std::unique_ptr<std::uint32_t[]> serial{new std::uint32_t[k_DataSize]};
+
+  TaskSubmitAndWait(Job::ParallelGenerateRandom(run_a.get(), k_DataSize, 42u));
+  TaskSubmitAndWait(Job::ParallelGenerateRandom(run_b.get(), k_DataSize, 42u));
+
+  for (std::size_t chunk_start = 0u; chunk_start < k_DataSize; chunk_start += Job::k_RandomChunkSize)
+  {
+    const std::size_t chunk_count = std::min(Job::k_RandomChunkSize, k_DataSize - chunk_start);
+
+    Job::RandomStream(42u, chunk_start / Job::k_RandomChunkSize).Fill(serial.get() + chunk_start, chunk_count);
+  }
+
+  EXPECT_TRUE(std::equal(run_a.get(), run_a.get() + k_DataSize, run_b.get()));
+  EXPECT_TRUE(std::equal(run_a.get(), run_a.get() + k_DataSize, serial.get()));
+  EXPECT_NE(run_a[0], run_a[Job::k_RandomChunkSize]) << "Chunks are expected to use different streams.";
+
+  Job::Task* const task = Job::ParallelFor(
+   0, 1000, Job::Splitter::MaxItemsPerTask(10), [](Job::Task*, const std::size_t) {
+     EXPECT_LT(Job::TaskRng().NextBounded(10u), 10u);
+   });
+
+  TaskSubmitAndWait(task);
+}
+
+// Tests `ParallelShuffle` / `ParallelSample` produce a permutation / subset and are deterministic.
+TEST(JobSystemTests, ParallelShuffleAndSample)
+{
+  static constexpr std::size_t k_DataSize   = Job::k_RandomChunkSize * 7 + 31;
+  static constexpr std::size_t k_SampleSize = 20000;
+
+  std::vector<int> shuffle_a(k_DataSize);
+  std::vector<int> shuffle_b(k_DataSize);
+
+  std::iota(shuffle_a.begin(), shuffle_a.end(), 0);
+  std::iota(shuffle_b.begin(), shuffle_b.end(), 0);
+
+  Job::ParallelShuffle(shuffle_a.begin(), shuffle_a.end(), 1234u);
+  Job::ParallelShuffle(shuffle_b.data(), shuffle_b.data() + k_DataSize, 1234u);
+
+  EXPECT_EQ(shuffle_a, shuffle_b);
+
+  std::size_t num_fixed_points = 0u;
+  for (std::size_t i = 0; i < k_DataSize; ++i)
+  {
+    num_fixed_points += shuffle_a[i] == int(i);
+  }
+  EXPECT_LT(num_fixed_points, 16u);
+
+  std::sort(shuffle_a.begin(), shuffle_a.end());
+  for (std::size_t i = 0; i < k_DataSize; ++i)
+  {
+    ASSERT_EQ(shuffle_a[i], int(i)) << "Shuffle is expected to be a permutation.";
+  }
+
+  std::vector<int> sample_a(k_SampleSize);
+  std::vector<int> sample_b(k_SampleSize);
+
+  EXPECT_EQ(Job::ParallelSample(shuffle_a.begin(), shuffle_a.end(), sample_a.begin(), k_SampleSize, 99u), k_SampleSize);
+  EXPECT_EQ(Job::ParallelSample(shuffle_a.begin(), shuffle_a.end(), sample_b.begin(), k_SampleSize, 99u), k_SampleSize);
+  EXPECT_EQ(sample_a, sample_b);
+
+  std::sort(sample_a.begin(), sample_a.end());
+  EXPECT_EQ(std::adjacent_find(sample_a.begin(), sample_a.end()), sample_a.end()) << "Sample must not contain duplicates.";
+  EXPECT_GE(sample_a.front(), 0);
+  EXPECT_LT(sample_a.back(), int(k_DataSize));
+}
+
+// Tests `ParallelRecurse` with both a value returning (fib) and void (quicksort) recursion.
+TEST(JobSystemTests, ParallelRecurse)
+{
+  const auto SerialFib = [](int n) -> std::uint64_t {
+    std::uint64_t a = 0u, b = 1u;
+    while (n-- > 0)
+    {
+      b = std::exchange(a, b) + b;
+    }
+    return a;
+  };
+
+  const std::uint64_t fib = Job::ParallelRecurse(
+   30,
+   [](const int n) { return n < 16; },
+   SerialFib,
+   [](const int n) { return std::array<int, 2>{n - 1, n - 2}; },
+   [](const int, const std::array<std::uint64_t, 2>& sub) { return sub[0] + sub[1]; });
+
+  EXPECT_EQ(fib, SerialFib(30));
+
+  struct SortRange
+  {
+    int* first;
+    int* last;
+  };
+
+  std::vector<int> data(200000);
+  Job::RandomStream rng{7u};
+
+  for (int& value : data)
+  {
+    value = int(rng.NextBounded(100000u));
+  }
+
+  Job::ParallelRecurse(
+   SortRange{data.data(), data.data() + data.size()},
+   [](const SortRange& range) { return range.last - range.first <= 512; },
+   [](const SortRange& range) { std::sort(range.first, range.last); },
+   [](const SortRange& range) {
+     const int  pivot  = range.first[(range.last - range.first) / 2];
+     int* const middle = std::partition(range.first, range.last, [pivot](const int v) { return v < pivot; });
+     int* const upper  = std::partition(middle, range.last, [pivot](const int v) { return v == pivot; });
+     return std::array<SortRange, 2>{SortRange{range.first, middle}, SortRange{upper, range.last}};
+   },
+   [](const SortRange&) {});
+
+  EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+}
+
+// Builds a CSR graph out of `edges`, the `columns` of each row are in edge order.
+static Job::CSRGraph MakeTestCSRGraph(const std::uint32_t num_vertices, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges, std::vector<std::uint64_t>& row_offsets, std::vector<std::uint32_t>& columns)
+{
+  row_offsets.assign(num_vertices + 1u, 0u);
+  columns.resize(edges.size());
+
+  for (const auto& edge : edges)
+  {
+    ++row_offsets[edge.first + 1u];
+  }
+
+  std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+
+  std::vector<std::uint64_t> write_offsets(row_offsets.begin(), row_offsets.end() - 1);
+
+  for (const auto& edge : edges)
+  {
+    columns[write_offsets[edge.first]++] = edge.second;
+  }
+
+  return Job::CSRGraph{row_offsets.data(), columns.data(), num_vertices};
+}
+
+// Tests `ParallelBFS` against a serial BFS in both top-down only and direction optimizing modes.
+TEST(JobSystemTests, ParallelBFS)
+{
+  static constexpr std::uint32_t k_NumVertices = 20000u;
+  static constexpr std::uint32_t k_NumEdges    = 60000u;
+
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> reversed_edges;
+  Job::RandomStream                                   rng{11u};
+
+  for (std::uint32_t i = 0u; i < k_NumEdges; ++i)
+  {
+    const std::uint32_t from = rng.NextBounded(k_NumVertices);
+    const std::uint32_t to   = rng.NextBounded(k_NumVertices);
+
+    edges.emplace_back(from, to);
+    reversed_edges.emplace_back(to, from);
+  }
+
+  std::vector<std::uint64_t> row_offsets, transposed_row_offsets;
+  std::vector<std::uint32_t> columns, transposed_columns;
+  const Job::CSRGraph        graph      = MakeTestCSRGraph(k_NumVertices, edges, row_offsets, columns);
+  const Job::CSRGraph        transposed = MakeTestCSRGraph(k_NumVertices, reversed_edges, transposed_row_offsets, transposed_columns);
+
+  std::vector<std::int32_t>  expected_levels(k_NumVertices, -1);
+  std::vector<std::uint32_t> queue = {0u};
+
+  expected_levels[0] = 0;
+
+  for (std::size_t i = 0u; i < queue.size(); ++i)
+  {
+    const std::uint32_t vertex = queue[i];
+
+    for (std::uint64_t edge = graph.row_offsets[vertex]; edge < graph.row_offsets[vertex + 1u]; ++edge)
+    {
+      if (expected_levels[graph.columns[edge]] == -1)
+      {
+        expected_levels[graph.columns[edge]] = expected_levels[vertex] + 1;
+        queue.push_back(graph.columns[edge]);
+      }
+    }
+  }
+
+  for (const bool allow_bottom_up : {false, true})
+  {
+    Job::BFSOptions options   = {};
+    options.transposed        = &transposed;
+    options.allow_bottom_up   = allow_bottom_up;
+    options.vertices_per_task = 256u;
+
+    std::vector<std::int32_t> levels(k_NumVertices, 42);
+    const std::size_t         num_reached = Job::ParallelBFS(graph, 0u, levels.data(), options);
+
+    EXPECT_EQ(num_reached, queue.size());
+    EXPECT_EQ(levels, expected_levels);
+  }
+}
+
+// Tests the byte kernels on misaligned buffers both below and above the streaming threshold.
+TEST(JobSystemTests, ParallelCopyFillTransform)
+{
+  for (const std::size_t num_bytes : {Job::k_BytesChunkSize * 3u + 77u, Job::k_BytesStreamingThreshold + 4099u})
+  {
+    std::vector<unsigned char> src(num_bytes + 1u);
+    std::vector<unsigned char> dst(num_bytes + 3u, 0xCD);
+
+    for (std::size_t i = 0; i < src.size(); ++i)
+    {
+      src[i] = static_cast<unsigned char>(i * 31u + (i >> 12));
+    }
+
+    Job::TaskSubmitAndWait(Job::ParallelCopy(dst.data() + 1, src.data() + 1, num_bytes));
+
+    EXPECT_EQ(std::memcmp(dst.data() + 1, src.data() + 1, num_bytes), 0);
+    EXPECT_EQ(dst[0], 0xCD);
+    EXPECT_EQ(dst[num_bytes + 1u], 0xCD);
+
+    Job::TaskSubmitAndWait(Job::ParallelFill(dst.data() + 1, 0x5A, num_bytes));
+
+    EXPECT_EQ(std::count(dst.begin() + 1, dst.begin() + 1 + num_bytes, 0x5A), std::ptrdiff_t(num_bytes));
+    EXPECT_EQ(dst[0], 0xCD);
+    EXPECT_EQ(dst[num_bytes + 1u], 0xCD);
+  }
+
+  std::vector<int>   values(1000003);
+  std::vector<float> halves(values.size());
+
+  std::iota(values.begin(), values.end(), 0);
+
+  Job::TaskSubmitAndWait(Job::ParallelTransform(values.data(), values.size(), halves.data(), [](const int value) { return float(value) * 0.5f; }));
+  Job::TaskSubmitAndWait(Job::ParallelTransform(values.data() + 1, values.size() - 1u, values.data() + 1, [](const int value) { return -value; }));
+
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    ASSERT_EQ(halves[i], float(i) * 0.5f);
+    ASSERT_EQ(values[i], -int(i));
+  }
+}
+
+// Tests `ParallelForEachLine` with chunks much smaller than some of the lines.
+TEST(JobSystemTests, ParallelForEachLine)
+{
+  static constexpr const char* k_Path = "job_sys_test_lines.txt";
+
+  struct LineStats
+  {
+    std::size_t num_lines;
+    std::size_t num_bytes;
+  };
+
+  std::string contents;
+  LineStats   expected = {0u, 0u};
+
+  for (std::size_t i = 0; i < 3000; ++i)
+  {
+    const std::size_t length = i % 97 == 0 ? 500u : i % 13;
+
+    contents.append(length, char('a' + i % 26));
+    contents.push_back('\n');
+
+    ++expected.num_lines;
+    expected.num_bytes += length;
+  }
+
+  // Final record without a trailing delimiter.
+  contents.append("end");
+  ++expected.num_lines;
+  expected.num_bytes += 3u;
+
+  std::FILE* const file = std::fopen(k_Path, "wb");
+  ASSERT_NE(file, nullptr);
+  std::fwrite(contents.data(), 1u, contents.size(), file);
+  std::fclose(file);
+
+  Job::LineOptions options = {};
+  options.chunk_size       = 64u;
+
+  Job::WorkerLocal<LineStats> results{LineStats{0u, 0u}};
+
+  const bool opened = Job::ParallelForEachLine(
+   k_Path, results, [](const std::string_view line, LineStats& stats) {
+     ++stats.num_lines;
+     stats.num_bytes += line.size();
+     EXPECT_EQ(line.find('\n'), std::string_view::npos);
+   },
+   options);
+
+  const LineStats total = results.Combine([](const LineStats& lhs, const LineStats& rhs) { return LineStats{lhs.num_lines + rhs.num_lines, lhs.num_bytes + rhs.num_bytes}; });
+
+  EXPECT_TRUE(opened);
+  EXPECT_EQ(total.num_lines, expected.num_lines);
+  EXPECT_EQ(total.num_bytes, expected.num_bytes);
+  EXPECT_FALSE(Job::ParallelForEachLine("job_sys_test_missing.txt", [](const std::string_view) {}));
+
+  std::remove(k_Path);
+}
+
+// Tests `ParallelForEachStream` reads on the calling thread, keeps buffers alive for child tasks and never exceeds the in flight limit.
+static void CheckForEachStream()
+{
+  static constexpr std::size_t k_ChunkSize   = 1000u;
+  static constexpr std::size_t k_MaxInFlight = 3u;
+
+  std::vector<unsigned char> source(k_ChunkSize * 200u + 123u);
+  std::uint64_t              expected_sum = 0u;
+
+  for (std::size_t i = 0; i < source.size(); ++i)
+  {
+    source[i] = static_cast<unsigned char>(i * 7u + (i >> 8));
+    expected_sum += source[i];
+  }
+
+  const std::thread::id      calling_thread = std::this_thread::get_id();
+  std::size_t                read_offset    = 0u;
+  bool                       read_elsewhere = false;
+  std::atomic<std::uint64_t> sum            = {0u};
+  std::atomic<std::size_t>   num_bytes      = {0u};
+  std::atomic<std::size_t>   in_flight      = {0u};
+  std::atomic<std::size_t>   max_seen       = {0u};
+
+  const auto reader = [&](char* const buffer, const std::size_t capacity) {
+    const std::size_t size = std::min(capacity, source.size() - read_offset);
+
+    read_elsewhere |= std::this_thread::get_id() != calling_thread;
+
+    std::memcpy(buffer, source.data() + read_offset, size);
+    read_offset += size;
+
+    return size;
+  };
+
+  Job::ParallelForEachStream(reader, k_ChunkSize, k_MaxInFlight, [&](Job::Task* const task, const char* const data, const std::size_t size, const std::size_t) {
+    const std::size_t now_in_flight = in_flight.fetch_add(1u) + 1u;
+    std::size_t       seen          = max_seen.load();
+
+    while (seen < now_in_flight && !max_seen.compare_exchange_weak(seen, now_in_flight))
+    {
+    }
+
+    num_bytes += size;
+
+    // The child reads the buffer after this function has returned.
+    Job::TaskSubmit(Job::TaskMake(
+     [&sum, &in_flight, data, size](Job::Task* const) {
+       std::uint64_t chunk_sum = 0u;
+
+       for (std::size_t i = 0; i < size; ++i)
+       {
+         chunk_sum += static_cast<unsigned char>(data[i]);
+       }
+
+       sum += chunk_sum;
+       in_flight.fetch_sub(1u);
+     },
+     task));
+  });
+
+  EXPECT_FALSE(read_elsewhere) << "The reader must only run on the calling thread.";
+  EXPECT_EQ(num_bytes.load(), source.size());
+  EXPECT_EQ(sum.load(), expected_sum);
+  EXPECT_LE(max_seen.load(), k_MaxInFlight);
+}
+
+TEST(JobSystemTests, ParallelForEachStream)
+{
+  CheckForEachStream();
+
+  // A single worker processes each chunk on the calling thread.
+  Job::Shutdown();
+
+  Job::JobSystemCreateOptions options = {};
+  options.num_threads                 = 1;
+
+  Job::Initialize(Job::JobSystemMemoryRequirements(options));
+  CheckForEachStream();
+  Job::Shutdown();
+  Job::Initialize();
+}
+
+// Tests `Crc32c` against known check values and `ParallelCrc32c` against the serial version.
+TEST(JobSystemTests, ParallelCrc32c)
+{
+  const unsigned char zeros[32] = {};
+
+  EXPECT_EQ(Job::Crc32c("123456789", 9u), 0xE3069283u);
+  EXPECT_EQ(Job::Crc32c(zeros, sizeof(zeros)), 0x8A9136AAu);
+  EXPECT_EQ(Job::Crc32cCombine(Job::Crc32c("1234", 4u), Job::Crc32c("56789", 5u), 5u), 0xE3069283u);
+
+  std::vector<unsigned char> data(Job::k_BytesChunkSize * 9u + 333u);
+  Job::RandomStream          rng{3u};
+
+  for (unsigned char& byte : data)
+  {
+    byte = static_cast<unsigned char>(rng.Next());
+  }
+
+  const std::uint32_t serial_crc = Job::Crc32c(data.data() + 1, data.size() - 1u);
+
+  EXPECT_EQ(Job::Crc32c(data.data() + 1 + 1000u, data.size() - 1001u, Job::Crc32c(data.data() + 1, 1000u)), serial_crc);
+  EXPECT_EQ(Job::ParallelCrc32c(data.data() + 1, data.size() - 1u), serial_crc);
+  EXPECT_EQ(Job::ParallelCrc32c(data.data(), 0u), 0u);
+}
+
+// Tests `ParallelMergeRuns` is stable and matches a serial stable sort, including empty and heavily duplicated runs.
+TEST(JobSystemTests, ParallelMergeRuns)
+{
+  struct Item
+  {
+    int         key;
+    std::size_t run;
+  };
+
+  static constexpr std::size_t k_NumRuns = 7u;
+
+  std::vector<std::vector<Item>>           runs(k_NumRuns);
+  std::vector<Job::MergeRun<const Item*>> merge_runs;
+  std::vector<Item>                        expected;
+  Job::RandomStream                        rng{5u};
+
+  for (std::size_t run = 0u; run < k_NumRuns; ++run)
+  {
+    const std::size_t run_size = run == 3u ? 0u : 5000u + rng.NextBounded(60000u);
+
+    for (std::size_t i = 0u; i < run_size; ++i)
+    {
+      runs[run].push_back(Item{int(rng.NextBounded(run % 2u ? 50u : 100000u)), run});
+    }
+
+    std::stable_sort(runs[run].begin(), runs[run].end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+    merge_runs.push_back({runs[run].data(), runs[run].data() + runs[run].size()});
+    expected.insert(expected.end(), runs[run].begin(), runs[run].end());
+  }
+
+  std::stable_sort(expected.begin(), expected.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+
+  std::vector<Item> merged(expected.size());
+
+  Job::ParallelMergeRuns(merge_runs.data(), merge_runs.size(), merged.begin(), [](const Item& a, const Item& b) { return a.key < b.key; });
+
+  for (std::size_t i = 0u; i < expected.size(); ++i)
+  {
+    ASSERT_EQ(merged[i].key, expected[i].key);
+    ASSERT_EQ(merged[i].run, expected[i].run);
+  }
+}
+
+// Tests `ParallelReduceByKeySorted` and `ParallelReduceByKey` against a serial `std::map`, including segments spanning many chunks.
+TEST(JobSystemTests, ParallelReduceByKey)
+{
+  static constexpr std::size_t k_NumElements = 200000u;
+
+  std::vector<std::uint32_t>             keys;
+  std::vector<std::uint64_t>             values;
+  std::map<std::uint32_t, std::uint64_t> expected;
+  Job::RandomStream                      rng{11u};
+  const auto                             Sum = [](const std::uint64_t a, const std::uint64_t b) { return a + b; };
+
+  for (std::uint32_t key = 0u; keys.size() < k_NumElements; ++key)
+  {
+    const std::size_t run_size = key % 5u == 0u ? 40000u : 1u + rng.NextBounded(20u);
+
+    for (std::size_t i = 0u; i < run_size && keys.size() < k_NumElements; ++i)
+    {
+      const std::uint64_t value = rng.NextBounded(1000u);
+
+      keys.push_back(key * 7u);
+      values.push_back(value);
+      expected[key * 7u] += value;
+    }
+  }
+
+  std::vector<std::uint32_t> out_keys(k_NumElements);
+  std::vector<std::uint64_t> out_values(k_NumElements);
+
+  const std::size_t num_segments = Job::ParallelReduceByKeySorted(keys.data(), values.data(), keys.size(), Sum, out_keys.data(), out_values.data());
+
+  ASSERT_EQ(num_segments, expected.size());
+
+  std::size_t index = 0u;
+
+  for (const auto& entry : expected)
+  {
+    ASSERT_EQ(out_keys[index], entry.first);
+    ASSERT_EQ(out_values[index], entry.second);
+    ++index;
+  }
+
+  for (std::size_t i = keys.size() - 1u; i > 0u; --i)
+  {
+    const std::size_t j = rng.NextBounded(std::uint32_t(i + 1u));
+
+    std::swap(keys[i], keys[j]);
+    std::swap(values[i], values[j]);
+  }
+
+  const std::size_t num_unique = Job::ParallelReduceByKey(keys.data(), values.data(), keys.size(), Sum, out_keys.data(), out_values.data());
+
+  ASSERT_EQ(num_unique, expected.size());
+
+  for (std::size_t i = 0u; i < num_unique; ++i)
+  {
+    const auto it = expected.find(out_keys[i]);
+
+    ASSERT_NE(it, expected.end());
+    ASSERT_EQ(out_values[i], it->second);
+    expected.erase(it);
+  }
+
+  EXPECT_EQ(Job::ParallelReduceByKey(keys.data(), values.data(), 0u, Sum, out_keys.data(), out_values.data()), 0u);
+}
+
+// Tests concurrent `ConcurrentHashMap::Insert` keeps exactly one value per key and `BulkInsert` agrees with it.
+TEST(JobSystemTests, ConcurrentHashMap)
+{
+  static constexpr std::size_t k_NumKeys = 50000u;
+
+  Job::ConcurrentHashMap<std::uint32_t, std::uint32_t> map{k_NumKeys};
+  std::atomic<std::size_t>                             num_inserted{0u};
+
+  // Every key is inserted twice by different tasks, only one insert may win.
+  Job::TaskSubmitAndWait(Job::ParallelFor(
+   std::size_t(0u), k_NumKeys * 2u, Job::Splitter::MaxItemsPerTask(512u), [&map, &num_inserted](Job::Task* const, const std::size_t index) {
+     const std::uint32_t key    = std::uint32_t(index % k_NumKeys) * 3u;
+     const auto          result = map.Insert(key, key + 1u);
+
+     ASSERT_NE(result.first, nullptr);
+     ASSERT_EQ(*result.first, key + 1u);
+     num_inserted.fetch_add(result.second);
+   }));
+
+  EXPECT_EQ(num_inserted.load(), k_NumKeys);
+  EXPECT_EQ(map.Size(), k_NumKeys);
+
+  Job::TaskSubmitAndWait(Job::ParallelFor(
+   std::uint32_t(0u), std::uint32_t(k_NumKeys * 3u), Job::Splitter::MaxItemsPerTask(512u), [&map](Job::Task* const, const std::uint32_t key) {
+     const std::uint32_t* const value = map.Find(key);
+
+     if (key % 3u == 0u)
+     {
+       ASSERT_NE(value, nullptr);
+       ASSERT_EQ(*value, key + 1u);
+     }
+     else
+     {
+       ASSERT_EQ(value, nullptr);
+     }
+   }));
+
+  std::vector<std::uint32_t> keys(k_NumKeys * 2u);
+  std::vector<std::uint32_t> values(k_NumKeys * 2u);
+
+  for (std::size_t i = 0u; i < keys.size(); ++i)
+  {
+    keys[i]   = std::uint32_t(i % k_NumKeys) * 3u;
+    values[i] = keys[i] + 1u;
+  }
+
+  Job::ConcurrentHashMap<std::uint32_t, std::uint32_t> bulk_map{k_NumKeys};
+
+  EXPECT_EQ(bulk_map.BulkInsert(keys.data(), values.data(), keys.size()), k_NumKeys);
+  EXPECT_EQ(bulk_map.BulkInsert(keys.data(), values.data(), k_NumKeys), 0u);
+
+  std::size_t num_visited = 0u;
+
+  bulk_map.ForEach([&map, &num_visited](const std::uint32_t& key, std::uint32_t& value) {
+    const std::uint32_t* const expected = map.Find(key);
+
+    ASSERT_NE(expected, nullptr);
+    ASSERT_EQ(value, *expected);
+    ++num_visited;
+  });
+
+  EXPECT_EQ(num_visited, k_NumKeys);
+
+  bulk_map.Clear();
+  EXPECT_EQ(bulk_map.Size(), 0u);
+  EXPECT_EQ(bulk_map.Find(3u), nullptr);
+}
+
+// Tests `ParallelTopK` and `ParallelNthElement` against the serial algorithms, including heavily duplicated data.
+TEST(JobSystemTests, ParallelTopKAndNthElement)
+{
+  static constexpr std::size_t k_NumElements = 400000u;
+
+  std::vector<std::uint32_t> data(k_NumElements);
+  Job::RandomStream          rng{17u};
+
+  for (std::uint32_t& value : data)
+  {
+    value = rng.NextBounded(1000000u);
+  }
+
+  for (const std::size_t k : {std::size_t(1u), std::size_t(1000u), k_NumElements + 5u})
+  {
+    std::vector<std::uint32_t> expected = data;
+    std::vector<std::uint32_t> top(std::min(k, k_NumElements));
+    const std::size_t          num_top = std::min(k, k_NumElements);
+
+    std::partial_sort(expected.begin(), expected.begin() + num_top, expected.end(), std::greater<>{});
+    expected.resize(num_top);
+
+    ASSERT_EQ(Job::ParallelTopK(data.data(), data.size(), k, std::greater<>{}, top.data()), num_top);
+    ASSERT_EQ(top, expected);
+  }
+
+  for (const std::uint32_t max_value : {1000000u, 3u})
+  {
+    for (std::uint32_t& value : data)
+    {
+      value = rng.NextBounded(max_value);
+    }
+
+    std::vector<std::uint32_t> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (const std::size_t nth : {std::size_t(0u), std::size_t(12345u), k_NumElements / 2u, k_NumElements - 1u})
+    {
+      std::vector<std::uint32_t> selected = data;
+
+      Job::ParallelNthElement(selected.begin(), selected.begin() + nth, selected.end());
+
+      ASSERT_EQ(selected[nth], sorted[nth]);
+      ASSERT_TRUE(std::all_of(selected.begin(), selected.begin() + nth, [&](const std::uint32_t value) { return value <= selected[nth]; }));
+      ASSERT_TRUE(std::all_of(selected.begin() + nth, selected.end(), [&](const std::uint32_t value) { return value >= selected[nth]; }));
+    }
+  }
+}
+
+// Tests the numeric kernels against serial loops on unaligned data with a tail that does not fill a vector.
+TEST(JobSystemTests, ParallelNumericKernels)
+{
+  static constexpr std::size_t k_NumElements = 3u * Job::k_NumericChunkSize + 37u;
+
+  std::vector<float> buffer(k_NumElements + 1u);
+  Job::RandomStream  rng{23u};
+
+  for (float& value : buffer)
+  {
+    value = float(rng.NextBounded(2000001u)) / 1000.0f - 1000.0f;
+  }
+
+  // The minimum appears twice, the first one must be reported.
+  buffer[1u + 100000u] = -5000.0f;
+  buffer[1u + 150000u] = -5000.0f;
+  buffer[1u + 77u]     = 7000.0f;
+
+  const float* const data      = buffer.data() + 1u;
+  double             sum       = 0.0;
+  float              min       = data[0];
+  float              max       = data[0];
+  std::size_t        min_index = 0u;
+
+  for (std::size_t i = 0u; i < k_NumElements; ++i)
+  {
+    sum += data[i];
+    max = std::max(max, data[i]);
+
+    if (data[i] < min)
+    {
+      min       = data[i];
+      min_index = i;
+    }
+  }
+
+  EXPECT_NEAR(Job::ParallelSum(data, k_NumElements), sum, 1e-6 * double(k_NumElements) * 1000.0);
+
+  const Job::MinMaxResult min_max = Job::ParallelMinMax(data, k_NumElements);
+  EXPECT_EQ(min_max.min, -5000.0f);
+  EXPECT_EQ(min_max.max, 7000.0f);
+
+  const Job::ArgMinResult arg_min = Job::ParallelArgMin(data, k_NumElements);
+  EXPECT_EQ(arg_min.value, min);
+  EXPECT_EQ(arg_min.index, min_index);
+  EXPECT_EQ(min_index, 100000u);
+
+  EXPECT_EQ(Job::ParallelSum(data, 0u), 0.0);
+  EXPECT_EQ(Job::ParallelArgMin(data, 0u).index, 0u);
+
+  // Spans several chunks so the result must come from the chunk partials rather than the empty range default.
+  const std::vector<float> all_infinity(2u * Job::k_NumericChunkSize + 5u, std::numeric_limits<float>::infinity());
+  const Job::ArgMinResult  arg_min_infinity = Job::ParallelArgMin(all_infinity.data(), all_infinity.size());
+  EXPECT_EQ(arg_min_infinity.value, std::numeric_limits<float>::infinity());
+  EXPECT_EQ(arg_min_infinity.index, 0u);
+  EXPECT_EQ(Job::ParallelMinMax(data + 5u, 3u).max, std::max({data[5], data[6], data[7]}));
+}
+
+// Tests the `std_par` overloads give the same results as the `std::` algorithms, including the serial fallbacks.
+TEST(JobSystemTests, StdParAlgorithms)
+{
+  static constexpr std::size_t k_NumElements = 300000u;
+
+  struct Item
+  {
+    std::uint32_t key;
+    std::uint32_t order;
+  };
+
+  std::vector<std::uint32_t> data(k_NumElements);
+  Job::RandomStream          rng{29u};
+
+  for (std::uint32_t& value : data)
+  {
+    value = rng.NextBounded(100000u);
+  }
+
+  std::vector<std::uint32_t> doubled(k_NumElements);
+  std::vector<std::uint32_t> expected(k_NumElements);
+
+  Job::std_par::transform(Job::execution::par, data.begin(), data.end(), doubled.begin(), [](const std::uint32_t value) { return value * 2u; });
+  std::transform(data.begin(), data.end(), expected.begin(), [](const std::uint32_t value) { return value * 2u; });
+  EXPECT_EQ(doubled, expected);
+
+  Job::std_par::for_each(Job::execution::par, doubled.begin(), doubled.end(), [](std::uint32_t& value) { value += 1u; });
+  EXPECT_EQ(Job::std_par::count_if(Job::execution::par, doubled.begin(), doubled.end(), [](const std::uint32_t value) { return value % 2u == 1u; }), std::ptrdiff_t(k_NumElements));
+
+  const std::uint64_t sum = std::accumulate(data.begin(), data.end(), std::uint64_t(0u));
+  EXPECT_EQ(Job::std_par::reduce(Job::execution::par, data.begin(), data.end(), std::uint64_t(7u)), sum + 7u);
+  EXPECT_EQ(Job::std_par::transform_reduce(Job::execution::par, data.begin(), data.end(), std::uint64_t(0u), std::plus<>{}, [](const std::uint32_t value) { return std::uint64_t(value) * 3u; }), sum * 3u);
+
+  data[200000u] = 123456789u;
+  EXPECT_EQ(Job::std_par::find(Job::execution::par, data.begin(), data.end(), 123456789u), data.begin() + 200000);
+  EXPECT_TRUE(Job::std_par::any_of(Job::execution::par, data.begin(), data.end(), [](const std::uint32_t value) { return value == 123456789u; }));
+  EXPECT_FALSE(Job::std_par::all_of(Job::execution::par, data.begin(), data.end(), [](const std::uint32_t value) { return value < 100000u; }));
+  EXPECT_TRUE(Job::std_par::none_of(Job::execution::par, data.begin(), data.end(), [](const std::uint32_t value) { return value == 100000u; }));
+
+  std::vector<Item> items(k_NumElements);
+  for (std::size_t i = 0u; i < k_NumElements; ++i)
+  {
+    items[i] = Item{rng.NextBounded(1000u), std::uint32_t(i)};
+  }
+
+  std::vector<Item> expected_items = items;
+  std::vector<Item> unstable_items = items;
+  const auto        ByKey          = [](const Item& a, const Item& b) { return a.key < b.key; };
+
+  std::stable_sort(expected_items.begin(), expected_items.end(), ByKey);
+  Job::std_par::stable_sort(Job::execution::par, items.begin(), items.end(), ByKey);
+  Job::std_par::sort(Job::execution::par, unstable_items.begin(), unstable_items.end(), ByKey);
+
+  // `std_par::sort` falls back to `std::sort` with a single worker so only its keys are compared.
+  for (std::size_t i = 0u; i < k_NumElements; ++i)
+  {
+    ASSERT_EQ(items[i].key, expected_items[i].key);
+    ASSERT_EQ(items[i].order, expected_items[i].order);
+    ASSERT_EQ(unstable_items[i].key, expected_items[i].key);
+  }
+
+  std::vector<std::uint32_t> sorted = data;
+  Job::std_par::sort(Job::execution::par, sorted.begin(), sorted.end());
+  EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+
+  Job::std_par::fill(Job::execution::par, sorted.begin(), sorted.end(), 5u);
+  Job::std_par::copy(Job::execution::seq, sorted.begin(), sorted.begin() + 10, data.begin());
+  EXPECT_EQ(Job::std_par::count(Job::execution::par, sorted.begin(), sorted.end(), 5u), std::ptrdiff_t(k_NumElements));
+  EXPECT_EQ(data[9], 5u);
+
+  // Not random access, runs the serial algorithm.
+  std::list<int> list = {3, 1, 2};
+  Job::std_par::for_each(Job::execution::par, list.begin(), list.end(), [](int& value) { value *= 10; });
+  EXPECT_EQ(Job::std_par::reduce(Job::execution::par, list.begin(), list.end()), 60);
+}
+
+TEST(JobSystemTests, ChunkedSoAForEachChunk)
+{
+  struct Position
+  {
+    float x, y, z;
+  };
+
+  using Container = Job::ChunkedSoA<Position, float, std::string>;
+
+  static constexpr std::size_t k_NumElements = 5u * Container::k_ElementsPerChunk + 11u;
+
+  Container soa;
+
+  for (std::size_t i = 0u; i < k_NumElements; ++i)
+  {
+    soa.PushBack(Position{float(i), 0.0f, 0.0f}, 2.0f, std::to_string(i));
+  }
+
+  ASSERT_EQ(soa.Size(), k_NumElements);
+  ASSERT_EQ(soa.NumChunks(), 6u);
+  EXPECT_EQ(soa.Chunk(5u).count, 11u);
+
+  for (std::size_t chunk_index = 0u; chunk_index < soa.NumChunks(); ++chunk_index)
+  {
+    const Container::ChunkView chunk = soa.Chunk(chunk_index);
+
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(chunk.Get<0>()) % Job::k_SoAArrayAlignment, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(chunk.Get<1>()) % Job::k_SoAArrayAlignment, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(chunk.Get<2>()) % Job::k_SoAArrayAlignment, 0u);
+  }
+
+  std::atomic<std::size_t> num_visited = {0u};
+
+  Job::TaskSubmitAndWait(Job::ParallelForEachChunk(soa, [&num_visited](Job::Task* const, const Container::ChunkView& chunk) {
+    Position* const    positions = chunk.Get<Position>();
+    const float* const speeds    = chunk.Get<float>();
+
+    for (std::size_t i = 0u; i < chunk.count; ++i)
+    {
+      positions[i].y += speeds[i] * float(chunk.first + i);
+    }
+
+    num_visited.fetch_add(chunk.count, std::memory_order_relaxed);
+  }));
+
+  EXPECT_EQ(num_visited.load(), k_NumElements);
+
+  for (std::size_t i = 0u; i < k_NumElements; ++i)
+  {
+    ASSERT_EQ(soa.Get<0>(i).x, float(i));
+    ASSERT_EQ(soa.Get<0>(i).y, 2.0f * float(i));
+    ASSERT_EQ(soa.Get<2>(i), std::to_string(i));
+  }
+
+  soa.SwapRemove(3u);
+  EXPECT_EQ(soa.Size(), k_NumElements - 1u);
+  EXPECT_EQ(soa.Get<2>(3u), std::to_string(k_NumElements - 1u));
+
+  while (soa.Size() > 1u)
+  {
+    soa.SwapRemove(soa.Size() - 1u);
+  }
+  EXPECT_EQ(soa.NumChunks(), 1u);
+
+  soa.Clear();
+  EXPECT_TRUE(soa.IsEmpty());
+  Job::TaskSubmitAndWait(Job::ParallelForEachChunk(soa, [](Job::Task* const, const Container::ChunkView&) { FAIL(); }));
+}
+
+TEST(JobSystemTests, DataFlowInferredDependencies)
+{
+  static constexpr std::size_t k_NumResources = 16u;
+  static constexpr std::size_t k_NumTasks     = 2000u;
+
+  struct Step
+  {
+    std::uint32_t reads[2];
+    std::uint32_t write;
+  };
+
+  std::array<std::uint64_t, k_NumResources> expected  = {};
+  std::array<std::uint64_t, k_NumResources> resources = {};
+  std::vector<Step>                         steps(k_NumTasks);
+  Job::RandomStream                         rng{41u};
+
+  for (Step& step : steps)
+  {
+    step.reads[0] = rng.NextBounded(k_NumResources);
+    step.reads[1] = rng.NextBounded(k_NumResources);
+    step.write    = rng.NextBounded(k_NumResources);
+  }
+
+  const auto Apply = [](std::uint64_t* const values, const Step& step, const std::size_t index) {
+    values[step.write] = values[step.write] * 31u + values[step.reads[0]] * 7u + values[step.reads[1]] + index;
+  };
+
+  Job::DataFlow flow;
+
+  // Twice to check the graph is reusable after a `Wait`.
+  for (int frame = 0; frame < 2; ++frame)
+  {
+    for (std::size_t i = 0u; i < k_NumTasks; ++i)
+    {
+      const Step& step = steps[i];
+
+      Apply(expected.data(), step, i);
+      flow.Submit(Job::Reads(resources[step.reads[0]], resources[step.reads[1]]), Job::Writes(resources[step.write]), [&resources, &step, i, Apply](Job::Task* const) {
+        Apply(resources.data(), step, i);
+      });
+    }
+
+    EXPECT_EQ(flow.NumSubmitted(), k_NumTasks);
+    flow.Wait();
+    EXPECT_EQ(resources, expected);
+    EXPECT_EQ(flow.NumSubmitted(), 0u);
+  }
+
+  // Readers of the same resource only wait on the writer before them and block the writer after them.
+  std::atomic<int>    num_readers_done = {0};
+  std::vector<int>    buffer(1000u, 0);
+  std::array<int, 8u> sums             = {};
+  int                 readers_seen     = -1;
+
+  flow.Submit(Job::Writes(buffer), [&buffer](Job::Task* const) { std::fill(buffer.begin(), buffer.end(), 1); });
+
+  for (int& sum : sums)
+  {
+    flow.Submit(Job::Reads(buffer), Job::Writes(sum), [&buffer, &sum, &num_readers_done](Job::Task* const) {
+      sum = std::accumulate(buffer.begin(), buffer.end(), 0);
+      num_readers_done.fetch_add(1);
+    });
+  }
+
+  flow.Submit(Job::Writes(buffer), [&buffer, &num_readers_done, &readers_seen](Job::Task* const) {
+    readers_seen = num_readers_done.load();
+    std::fill(buffer.begin(), buffer.end(), 2);
+  });
+  flow.Wait();
+
+  EXPECT_EQ(readers_seen, int(sums.size()));
+  EXPECT_EQ(buffer.front(), 2);
+
+  for (const int sum : sums)
+  {
+    EXPECT_EQ(sum, 1000);
+  }
+
+  // Nothing submitted is a no-op.
+  flow.Wait();
+}
+
+TEST(JobSystemTests, RecordAndReplay)
+{
+  static constexpr int k_NumChildren = 50;
+  static constexpr int k_NumReplays  = 3;
+
+  std::atomic<int> num_children_run = {0};
+  std::atomic<int> num_roots_run    = {0};
+  std::atomic<int> nested_sum       = {0};
+  std::atomic<int> continuation_saw = {0};
+
+  Job::BeginRecord();
+  EXPECT_TRUE(Job::IsRecording());
+
+  Job::Task* const root = Job::TaskMake([&num_roots_run, &nested_sum](Job::Task* const) {
+    num_roots_run.fetch_add(1);
+
+    // Work spawned while running is dynamic and comes from the worker pools as usual.
+    Job::TaskSubmitAndWait(Job::ParallelFor(0, 100, Job::Splitter::MaxItemsPerTask(10), [&nested_sum](Job::Task* const, const std::size_t index) {
+      nested_sum.fetch_add(int(index));
+    }));
+  });
+
+  for (int i = 0; i < k_NumChildren; ++i)
+  {
+    Job::TaskSubmit(Job::TaskMake([&num_children_run](Job::Task* const) { num_children_run.fetch_add(1); }, root));
+  }
+
+  Job::Task* const continuation = Job::TaskMake([&num_children_run, &continuation_saw](Job::Task* const) {
+    continuation_saw.fetch_add(num_children_run.load());
+  });
+
+  Job::TaskAddContinuation(root, continuation);
+  Job::TaskSubmit(root);
+
+  Job::TaskGraph* const graph = Job::EndRecord();
+  EXPECT_FALSE(Job::IsRecording());
+
+  // Nothing runs while recording.
+  EXPECT_EQ(num_roots_run.load(), 0);
+  EXPECT_EQ(num_children_run.load(), 0);
+  EXPECT_EQ(Job::TaskGraphNumTasks(graph), std::size_t(k_NumChildren + 2));
+
+  for (int replay = 1; replay <= k_NumReplays; ++replay)
+  {
+    Job::Replay(graph);
+
+    EXPECT_EQ(num_roots_run.load(), replay);
+    EXPECT_EQ(num_children_run.load(), replay * k_NumChildren);
+    EXPECT_EQ(nested_sum.load(), replay * 4950);
+  }
+
+  // The continuation only runs after the root and all of its children.
+  EXPECT_EQ(continuation_saw.load(), k_NumChildren * (1 + 2 + 3));
+
+  Job::TaskGraphDestroy(graph);
+}
+
+TEST(JobSystemTests, CriticalPathReplay)
+{
+  std::atomic<int> num_run = {0};
+
+  const auto MakeCounted = [&num_run](Job::Task* const parent) {
+    return Job::TaskMake([&num_run](Job::Task* const) { num_run.fetch_add(1); }, parent);
+  };
+
+  Job::BeginRecord();
+
+  Job::Task* const a = MakeCounted(nullptr);
+  Job::Task* const b = MakeCounted(nullptr);
+  Job::Task* const c = MakeCounted(nullptr);
+  Job::Task* const d = MakeCounted(nullptr);
+  Job::Task* const e = MakeCounted(a);
+
+  Job::TaskSetCostHint(a, 1.0f);
+  Job::TaskSetCostHint(b, 2.0f);
+  Job::TaskSetCostHint(c, 3.0f);
+  Job::TaskSetCostHint(d, 4.0f);
+  Job::TaskSetCostHint(e, 10.0f);
+
+  Job::TaskAddContinuation(b, c);
+  Job::TaskAddContinuation(a, b);
+  Job::TaskSubmit(d);
+  Job::TaskSubmit(e);
+  Job::TaskSubmit(a);
+
+  Job::TaskGraph* const hinted_graph = Job::EndRecord();
+
+  // `b` waits on `a` which waits on its child `e`: e (10) + b (2) + c (3).
+  EXPECT_FLOAT_EQ(Job::TaskGraphCriticalPathCost(hinted_graph), 15.0f);
+
+  Job::TaskGraphSetSchedule(hinted_graph, Job::TaskGraphSchedule::CRITICAL_PATH);
+
+  for (int replay = 1; replay <= 3; ++replay)
+  {
+    Job::Replay(hinted_graph);
+    EXPECT_EQ(num_run.load(), replay * 5);
+  }
+
+  Job::TaskGraphDestroy(hinted_graph);
+
+  // Without hints each task starts at a cost of 1 then uses its measured time.
+  Job::BeginRecord();
+
+  Job::Task* const first  = MakeCounted(nullptr);
+  Job::Task* const second = MakeCounted(nullptr);
+
+  Job::TaskAddContinuation(first, second);
+  Job::TaskSubmit(first);
+  Job::TaskSubmit(MakeCounted(nullptr));
+
+  Job::TaskGraph* const measured_graph = Job::EndRecord();
+
+  EXPECT_FLOAT_EQ(Job::TaskGraphCriticalPathCost(measured_graph), 2.0f);
+
+  Job::TaskGraphSetSchedule(measured_graph, Job::TaskGraphSchedule::CRITICAL_PATH);
+  Job::Replay(measured_graph);
+
+  EXPECT_EQ(num_run.load(), 15 + 3);
+  EXPECT_GT(Job::TaskGraphCriticalPathCost(measured_graph), 0.0f);
+
+  Job::TaskGraphDestroy(measured_graph);
+}
+
+static std::uint64_t HeartbeatFibonacci(const std::uint64_t n)
+{
+  if (n < 2u)
+  {
+    return n;
+  }
+
+  std::uint64_t a, b;
+  Job::HeartbeatFork2([&a, n]() { a = HeartbeatFibonacci(n - 1u); }, [&b, n]() { b = HeartbeatFibonacci(n - 2u); });
+
+  return a + b;
+}
+
+// Tests latent forks producing the same results whether or not a heartbeat promoted them.
+TEST(JobSystemTests, HeartbeatForkJoin)
+{
+  EXPECT_EQ(HeartbeatFibonacci(27u), 196418u);
+
+  static constexpr std::size_t k_NumRows   = 64u;
+  static constexpr std::size_t k_RowLength = 4096u;
+
+  std::vector<std::uint32_t> num_visits(k_NumRows * k_RowLength, 0u);
+
+  Job::HeartbeatParallelFor(0u, k_NumRows, [&num_visits](const std::size_t row) {
+    Job::HeartbeatParallelFor(row * k_RowLength, k_RowLength, [&num_visits](const std::size_t index) {
+      ++num_visits[index];
+    });
+  });
+
+  EXPECT_EQ(std::count(num_visits.begin(), num_visits.end(), 1u), std::ptrdiff_t(num_visits.size())) << "Each index must be visited exactly once.";
+}
+
+// Tests the receiver-initiated scheduler running nested work correctly, then restores the default scheduler.
+TEST(JobSystemTests, PrivateDequeWorkStealing)
+{
+  int                    backing_storage[4];
+  Job::PrivateDeque<int> deque{};
+  int                    value = 0;
+
+  deque.Initialize(backing_storage, 4);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_TRUE(deque.Push(i));
+  }
+
+  EXPECT_FALSE(deque.Push(4));
+  EXPECT_TRUE(deque.Pop(&value) && value == 3);
+  EXPECT_TRUE(deque.PopOldest(&value) && value == 0);
+  EXPECT_TRUE(deque.Pop(&value) && value == 2);
+  EXPECT_TRUE(deque.Pop(&value) && value == 1);
+  EXPECT_FALSE(deque.PopOldest(&value));
+
+  Job::Shutdown();
+
+  Job::JobSystemCreateOptions options = {};
+  options.num_threads                 = 4;
+  options.work_stealing               = Job::WorkStealing::PRIVATE_DEQUES;
+
+  Job::Initialize(Job::JobSystemMemoryRequirements(options));
+
+  EXPECT_EQ(Fork2Fibonacci(24u), 46368u);
+
+  static constexpr std::size_t k_NumItems = 100000u;
+
+  std::vector<std::atomic<int>> num_visits(k_NumItems);
+
+  Job::TaskSubmitAndWait(Job::ParallelFor(std::size_t(0u), k_NumItems, Job::Splitter::MaxItemsPerTask(64u), [&num_visits](Job::Task* const, const std::size_t index) {
+    num_visits[index].fetch_add(1, std::memory_order_relaxed);
+  }));
+
+  EXPECT_TRUE(std::all_of(num_visits.begin(), num_visits.end(), [](const std::atomic<int>& count) { return count.load() == 1; })) << "Each index must be visited exactly once.";
+
+  Job::Shutdown();
+  Job::Initialize();
+}
+
+// Tests the shared deques with the owner's fence swapped for a thief side heavy fence (or the fallback), then restores the default scheduler.
+TEST(JobSystemTests, AsymmetricFenceWorkStealing)
+{
+  Job::Shutdown();
+
+  Job::JobSystemCreateOptions options = {};
+  options.num_threads                 = 4;
+  options.work_stealing               = Job::WorkStealing::ASYMMETRIC_FENCES;
+
+  Job::Initialize(Job::JobSystemMemoryRequirements(options));
+
+  EXPECT_EQ(Fork2Fibonacci(24u), 46368u);
+
+  static constexpr std::size_t k_NumItems = 20000u;
+
+  std::vector<std::atomic<int>> num_visits(k_NumItems);
+
+  // Single item tasks so the owners' pops race the thieves as often as possible.
+  Job::TaskSubmitAndWait(Job::ParallelFor(std::size_t(0u), k_NumItems, Job::Splitter::MaxItemsPerTask(1u), [&num_visits](Job::Task* const, const std::size_t index) {
+    num_visits[index].fetch_add(1, std::memory_order_relaxed);
+  }));
+
+  EXPECT_TRUE(std::all_of(num_visits.begin(), num_visits.end(), [](const std::atomic<int>& count) { return count.load() == 1; })) << "Each index must be visited exactly once.";
+
+  Job::Shutdown();
+  Job::Initialize();
+}
+
 // TODO(SR): Test continuations.
 
 int main(int argc, char* argv[])